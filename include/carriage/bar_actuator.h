@@ -21,6 +21,8 @@ public:
   void init();
 
   void proc();
+
+  std::shared_ptr<Carriage<double>> clone() const;
     
 private:
   size_t n;
@@ -22,6 +22,8 @@ public:
   void init();
 
   void proc();
+
+  std::shared_ptr<Carriage<double>> clone() const;
   
 private:
   size_t n;
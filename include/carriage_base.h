@@ -14,6 +14,12 @@
 #include <list>
 #include <thread>
 #include <functional>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <typeinfo>
+#include "carriage_meta.h"
+#include "carriage_value.h"
 
 #define FUNC_NAME " ["  << __FUNCTION__ << "] "
 #define EqualCriterion(name, criterion)                       \
@@ -36,33 +42,57 @@ enum class ExecutionOutcome:int {
   FAIL=-2,
 };
 
+static constexpr size_t kBlobInlineBytes = 32;
+
 /**
  * @class Blob
- * @brief The class that contains the elementary storage for target value and current value
+ * @brief The class that contains the elementary storage for target value and current value,
+ *        targets and currents share one array that lives inside the blob when it is small enough
  */
 template <typename T>
 class Blob {
+  static_assert(std::is_trivially_copyable<T>::value, "Please use plain types");
 public:
+  static constexpr size_t kInlineSize = kBlobInlineBytes/sizeof(T);
 
   /**
    * @brief The default constructor that takes the size of the target/current value as input
    * @param l The length of the target/current T value pointer
    */
-  explicit Blob(const size_t& l) {
-    len = l;
-    for(size_t i=0;i<len;i++) {target.push_back(T());}
-    for(size_t i=0;i<len;i++) {current.push_back(T());}
+  explicit Blob(const size_t& l):
+  len(0)
+  {
+    resize(l);
+  }
+
+  /**
+   * @brief The default copy constructor
+   */
+  Blob(const Blob& obj):
+  len(0)
+  {
+    *this = obj;
   }
 
   /**
    * @brief The default copy assigner
    */
-  Blob(const Blob& obj) {*this = obj;}
+  Blob& operator=(const Blob& obj) {
+    if (this != &obj) {
+      release();
+      len = 0;
+      resize(obj.len);
+      std::copy(obj.values(), obj.values()+2*len, values());
+    }
+    return *this;
+  }
 
   /**
    * @brief The default destructor
    */
-  virtual ~Blob() = default;
+  ~Blob() {
+    release();
+  }
 
   /**
    * @brief The default constructor that takes the size of the target/current value as input
@@ -70,9 +100,9 @@ public:
    */
   template<typename... Args>
   inline void setTarget(Args&&... args) {
-    len = sizeof...(args);
-    std::vector<T> list = {args...};
-    target = std::move(list);
+    resize(sizeof...(args));
+    const T list[] = {valueCast<T>(args)...};
+    std::copy(list, list+len, values());
   }
 
   /**
@@ -81,16 +111,34 @@ public:
    */
   template<typename... Args>
   inline void setCurrent(Args&&... args) {
-    len = sizeof...(args);
-    std::vector<T> list = {args...};
-    current = std::move(list);
+    resize(sizeof...(args));
+    const T list[] = {valueCast<T>(args)...};
+    std::copy(list, list+len, values()+len);
   }
   
   /**
    * @brief Set initial current value with default value
    */
   inline void setInitialCurrent() {
-    for(auto& c:current) {c=T();}
+    std::fill(values()+len, values()+2*len, T());
+  }
+
+  /**
+   * @brief Set a single current value in place
+   * @param index the index of the current value
+   * @param value the current value
+   */
+  inline void setCurrentAt(size_t index, const T& value) {
+    values()[len+index] = value;
+  }
+
+  /**
+   * @brief Set a single target value in place
+   * @param index the index of the target value
+   * @param value the target value
+   */
+  inline void setTargetAt(size_t index, const T& value) {
+    values()[index] = value;
   }
 
   /**
@@ -98,11 +146,11 @@ public:
    * @return target value
    */  
   inline T getTarget(size_t index) const {
-    return target[index];
+    return values()[index];
   }
 
   inline T getTarget() const {
-    return target[0];
+    return values()[0];
   }
 
   /**
@@ -110,70 +158,169 @@ public:
    * return current value
    */  
   inline T getCurrent(size_t index) const {
-    return current[index];
+    return values()[len+index];
   }
 
   inline T getCurrent() const {
-    return current[0];
+    return values()[len];
   }
   
 
   inline std::vector<T> getTargetVec() const {
-    return target;
+    return std::vector<T>(values(), values()+len);
   }
 
   inline std::vector<T> getCurrentVec() const {
-    return target;
+    return std::vector<T>(values()+len, values()+2*len);
+  }
+
+  /**
+   * @brief The raw target values, the current values follow them
+   * @return the pointer
+   */
+  inline const T* targetData() const {
+    return values();
+  }
+
+  inline const T* currentData() const {
+    return values()+len;
   }
 
-  size_t len;
+  /**
+   * @brief Change the number of target/current values, the leading values of both are kept
+   * @param l the new length
+   */
+  void resize(const size_t& l) {
+    if (l == len) {return;}
+    const size_t keep = std::min<size_t>(l, len);
+    T temp[kInlineSize];
+    T* next = 2*l>kInlineSize?new T[2*l]():temp;
+    std::fill(next, next+2*l, T());
+    std::copy(values(), values()+keep, next);
+    std::copy(values()+len, values()+len+keep, next+l);
+    release();
+    len = l;
+    if (isHeap()) {
+      heap_ = next;
+    } else {
+      std::copy(temp, temp+2*l, inline_);
+    }
+  }
+
+  uint32_t len;
 private:
-  std::vector<T> target, current;
+  inline bool isHeap() const {
+    return 2*len > kInlineSize;
+  }
+
+  inline T* values() {
+    return isHeap()?heap_:inline_;
+  }
+
+  inline const T* values() const {
+    return isHeap()?heap_:inline_;
+  }
+
+  inline void release() {
+    if (isHeap()) {delete[] heap_;}
+  }
+
+  union {
+    T inline_[kInlineSize];
+    T* heap_;
+  };
 };
 
+template <typename T>
+class Carriage;
+
 /**
- * @class Carriage
- * @brief The class that contructs the base actuator
+ * @class CarriageBase
+ * @brief The part of a carriage that does not depend on its value type, the train holds carriages through it.
+ *        The names, criteria, update frequency and deadline live in a CarriageMeta shared by the carriages
+ *        configured alike, an instance only keeps its values and flags
  */
-template <typename T>
-class Carriage {
+class CarriageBase {
 public:
 
   /**
    * @brief The default constructor
+   * @param name the carriage name
+   * @param is_complete complete or not
+   * @param type the value type of the derived carriage
    */  
-  template<typename... Args>
-  Carriage(const std::string& name,
-           const bool& is_complete, 
-           Args&&... args):
-    update_freq_(kLoopRate),
-    name_(name),
-    data_(sizeof...(args)),
-    is_complete_(is_complete)
+  CarriageBase(const std::string& name,
+               const bool& is_complete,
+               ValueType type):
+    meta_(nullptr),
+    count_(0),
+    is_complete_(is_complete),
+    is_initialized_(false),
+    outcome_(static_cast<int8_t>(ExecutionOutcome::SUCCESS)),
+    value_type_(type)
     {
-      setTarget(std::forward<Args>(args)...);
-      setInitialCurrent();
-      setGoalFunction("standard");
-      setEqualFunction("Roughly");
-      setUpdateFrequency(kLoopRate);
+      CarriageMeta meta;
+      meta.name = name;
+      applyGoal(meta, "standard");
+      applyEqual(meta, "Roughly");
+      applyUpdateFrequency(meta, kLoopRate);
+      meta_ = CarriageMetaTable::intern(meta);
     }
 
   /**
-   * @brief The default destructor
+   * @brief The copy constructor, the copy shares the metadata
    */  
-  virtual ~Carriage() = default;
+  CarriageBase(const CarriageBase& c):
+    meta_(c.meta_),
+    count_(c.count_),
+    is_complete_(c.is_complete_),
+    is_initialized_(c.is_initialized_),
+    outcome_(c.outcome_),
+    value_type_(c.value_type_)
+    {
+      CarriageMetaTable::acquire(meta_);
+    }
+
+  /**
+   * @brief The copy assigner, this carriage shares the metadata of the other one
+   */  
+  CarriageBase& operator=(const CarriageBase& c) {
+    if (this != &c) {
+      CarriageMetaTable::acquire(c.meta_);
+      CarriageMetaTable::release(meta_);
+      meta_ = c.meta_;
+      count_ = c.count_;
+      is_complete_ = c.is_complete_;
+      is_initialized_ = c.is_initialized_;
+      outcome_ = c.outcome_;
+      value_type_ = c.value_type_;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief The default destructor, the metadata is released
+   */  
+  virtual ~CarriageBase() {
+    CarriageMetaTable::release(meta_);
+  }
+
+  /**
+   * @brief Deep copy this carriage through the clone() of its value type
+   * @return the copy, nullptr if the actuator does not override clone() and the copy would be sliced
+   */  
+  inline std::shared_ptr<CarriageBase> clone() const {
+    return cloneMember();
+  }
 
   /**
    * @brief Set goal function as which the actuator is consider finished
    * @param goal_name The name of the goal
    */  
   virtual void setGoalFunction(const std::string& goal_name) {
-    goal_name_ = goal_name;
-    if (goal_name_=="standard") {
-      checkGoal = std::bind(&Carriage::naiveCheckGoal, this);   
-    } else {
-      checkGoal = std::bind(&Carriage::customizedCheckGoal, this);     
-    }
+    CarriageMeta meta = *meta_;
+    applyGoal(meta, goal_name);
+    assignMeta(meta);
   }
 
   /**
@@ -181,13 +328,9 @@ public:
    * @param goal_name The name of the goal
    */  
   virtual void setEqualFunction(const std::string& equal_name) {
-    namespace ph = std::placeholders;
-    equal_name_ = equal_name;
-    if (equal_name_ == "Strictly") {
-      checkEqual = std::bind(&StrictlyEqual, ph::_1, ph::_2);  
-    } else {
-      checkEqual = std::bind(&RoughlyEqual, ph::_1, ph::_2);     
-    }
+    CarriageMeta meta = *meta_;
+    applyEqual(meta, equal_name);
+    assignMeta(meta);
   }
 
   /**
@@ -195,107 +338,125 @@ public:
    * @param freq the frequency in Hz
    */ 
   virtual void setUpdateFrequency(const double& freq) {
-    update_freq_ = freq<=kLoopRate?freq:kLoopRate;
+    CarriageMeta meta = *meta_;
+    applyUpdateFrequency(meta, freq);
+    assignMeta(meta);
   }
 
   /**
-   * @brief Check the goal in a naive comarison way (conpare current and target with specific criterion)
-   * @param goal_name The name of the goal
+   * @brief Update frequency getter
+   * @return the frequency in Hz
    */ 
-  bool naiveCheckGoal() {
-    bool ret = true;
-    for(size_t i=0;i<data_.len;i++) {
-      const auto& compare_result = checkEqual(data_.getTarget(i), data_.getCurrent(i));
-      ret &= compare_result;
-      // std::cout << std::setprecision(7) << FUNC_NAME << "Compare result: " << compare_result 
-      // << ", Target[" << i << "]: " << *(data_.getTarget(i)) 
-      // << ", Current[" << i << "]: " << *(data_.getCurrent(i)) << std::endl;
-      }
-    return ret;
+  inline double updateFrequency() const {
+    return meta_->update_freq;
   }
 
   /**
-   * @brief Check whether the goal is finished by the is_complete_flag
-   * @return complete or not
+   * @brief Count a loop tick, a carriage is updated once every update_freq of the loop rate
+   * @return whether this tick is due for an update
    */ 
-  inline bool customizedCheckGoal() {
-    return is_complete_;
+  inline bool isUpdateDue() {
+    return count_++%meta_->update_div == 0;
   }
 
   /**
-   * @brief set target value and forward it to its data member
-   * @param args the arguments
+   * @brief The number of loop ticks counted so far, used when writing a checkpoint
+   * @return the count
    */ 
-  template<typename... Args>
-  void setTarget(Args&&... args) {
-    data_.setTarget(std::forward<Args>(args)...);
+  inline uint32_t updateCount() const {
+    return count_;
   }
 
   /**
-   * @brief set target value and forward it to its data member
-   * @param args the arguments
+   * @brief Set the number of loop ticks counted, used when restoring a checkpoint
+   * @param count the count
    */ 
-  template<typename... Args>
-  void setCurrent(Args&&... args) {
-    data_.setCurrent(std::forward<Args>(args)...);
+  inline void setUpdateCount(const uint32_t& count) {
+    count_ = count;
   }
 
   /**
-   * @brief set initial current value to data member
+   * @brief Evaluate the goal in place with the comparison of the value type, the criterion is read from the metadata
+   * @return complete or not
    */ 
-  inline void setInitialCurrent() {
-    data_.setInitialCurrent();
+  virtual bool evaluateGoal() const = 0;
+
+  /**
+   * @brief Check whether the goal is finished by the is_complete_flag
+   * @return complete or not
+   */ 
+  inline bool customizedCheckGoal() const {
+    return is_complete_;
   }
 
   /**
-   * @brief Get the value for the first current
-   * @param index the index of this current value
-   * @return the pointer of the current values
+   * @brief The value type getter
+   * @return the value type
    */ 
-  inline T getCurrent(size_t index) const {
-    return data_.getCurrent(index);
+  inline ValueType valueType() const {
+    return value_type_;
   }
 
   /**
-   * @brief Get the value for the first current
+   * @brief Get the number of target/current values
+   * @return the size
+   */
+  virtual size_t size() const = 0;
+
+  /**
+   * @brief Get a target value converted to double
+   * @param index the index
+   * @return the target value
+   */
+  virtual double targetValue(size_t index) const = 0;
+
+  /**
+   * @brief Get a current value converted to double
+   * @param index the index
    * @return the current value
    */
-  inline T getCurrent() const {
-    return data_.getCurrent();
-  } 
+  virtual double currentValue(size_t index) const = 0;
 
   /**
-   * @brief Get the vector for current values
-   * @return the vector
+   * @brief Set a single target value in place, converted from double
+   * @param index the index of the target value
+   * @param value the target value
    */
-  inline std::vector<T> getCurrentVec() const {
-    return data_.getCurrentVec();
-  } 
+  virtual void setTargetValue(size_t index, const double& value) = 0;
 
   /**
-   * @brief Get the vector for target values
-   * @return the vector
+   * @brief Set a single current value in place, converted from double
+   * @param index the index of the current value
+   * @param value the current value
    */
-  inline std::vector<T> getTargetVec() const {
-    return data_.getTargetVec();
-  } 
+  virtual void setCurrentValue(size_t index, const double& value) = 0;
 
   /**
-   * @brief Get target value with specified index
-   * @param index the index
-   * @return the target value
-   */  
-  inline T getTarget(size_t index) const {
-    return data_.getTarget(index);
-  } 
+   * @brief Set current values converted from double, the number of values may change
+   * @param values the current values
+   * @param len the number of values
+   */
+  virtual void setCurrentValues(const double* values, const size_t& len) = 0;
 
   /**
-   * @brief Get the first target value
-   * @return the target value
-   */  
-  inline T getTarget() const {
-    return data_.getTarget();
-  } 
+   * @brief Set the current values back to their default value
+   */
+  virtual void resetCurrent() = 0;
+
+  /**
+   * @brief set current value, the values are stored without conversion when their type is the value type
+   *        of this carriage, otherwise they go through double
+   * @param args the arguments
+   */ 
+  template<typename... Args>
+  void setCurrent(Args&&... args);
+
+  /**
+   * @brief Get the target values, copied without conversion when U is the value type of this carriage
+   * @return the vector
+   */
+  template<typename U = double>
+  std::vector<U> getTargetVec() const;
 
   /**
    * @brief The initialization function
@@ -307,7 +468,7 @@ public:
    */ 
   void update() {
     proc();
-    is_complete_ = checkGoal();
+    is_complete_ = evaluateGoal();
   }
 
   /**
@@ -324,16 +485,38 @@ public:
 
   /**
    * @brief Set complate
+   * @param complete complete or not
    */ 
-  inline void setComplete() {
-    is_complete_ = true;
+  inline void setComplete(const bool& complete = true) {
+    is_complete_ = complete;
   }
 
   /**
    * @brief Set initialzation true
+   * @param init initialized or not
+   */ 
+  inline void setInit(const bool& init = true) {
+    is_initialized_ = init;
+  }
+
+  /**
+   * @brief Clear the execution state(init and complete flags, update count, outcome and currents),
+   *        the targets and metadata are kept
    */ 
-  inline void setInit() {
-    is_initialized_ = true;
+  inline void reset() {
+    count_ = 0;
+    is_complete_ = false;
+    is_initialized_ = false;
+    outcome_ = static_cast<int8_t>(ExecutionOutcome::SUCCESS);
+    resetCurrent();
+  }
+
+  /**
+   * @brief Set the outcome, used when restoring a checkpoint
+   * @param outcome the outcome
+   */ 
+  inline void setOutcome(const ExecutionOutcome& outcome) {
+    outcome_ = static_cast<int8_t>(outcome);
   }
 
   /**
@@ -352,50 +535,362 @@ public:
     return is_initialized_;
   }
 
+  /**
+   * @brief Set the deadline, counted from the activation of the stage this carriage belongs to
+   * @param deadline the deadline
+   */ 
+  inline void setDeadline(const Deadline& deadline) {
+    CarriageMeta meta = *meta_;
+    meta.deadline = deadline;
+    assignMeta(meta);
+  }
+
+  /**
+   * @brief Deadline getter
+   * @return the deadline
+   */ 
+  inline const Deadline& deadline() const {
+    return meta_->deadline;
+  }
+
+  /**
+   * @brief Mark this carriage as timed out, it is treated as complete and no longer updated
+   */ 
+  inline void setTimeout() {
+    outcome_ = static_cast<int8_t>(ExecutionOutcome::TIMEOUT);
+    is_complete_ = true;
+  }
+
+  /**
+   * @brief Check if this carriage has timed out
+   * @return timed out or not
+   */ 
+  inline bool isTimeout() const {
+    return outcome_ == static_cast<int8_t>(ExecutionOutcome::TIMEOUT);
+  }
+
+  /**
+   * @brief Outcome getter
+   * @return the outcome
+   */ 
+  inline ExecutionOutcome outcome() const {
+    return static_cast<ExecutionOutcome>(outcome_);
+  }
+
   /**
    * @brief Observe if complete
    * @return complete or not
    */ 
-  inline std::string name() const {
-    return name_;
+  inline const std::string& name() const {
+    return meta_->name;
   }
 
   /**
    * @brief Observe the goal name
    * @return the goal name
    */ 
-  inline std::string goalName() const {
-    return goal_name_;
+  inline const std::string& goalName() const {
+    return meta_->goal_name;
   }
 
   /**
    * @brief Observe the equal criterion name
    * @return the equal criterion name
    */ 
-  inline std::string equalName() const {
-    return equal_name_;
+  inline const std::string& equalName() const {
+    return meta_->equal_name;
+  }
+
+  /**
+   * @brief Metadata getter
+   * @return the shared metadata
+   */ 
+  inline const CarriageMeta& meta() const {
+    return *meta_;
+  }
+
+private:
+  virtual std::shared_ptr<CarriageBase> cloneMember() const = 0;
+
+  static inline void applyGoal(CarriageMeta& meta, const std::string& goal_name) {
+    meta.goal_name = goal_name;
+    meta.is_standard_goal = goal_name=="standard";
+  }
+
+  static inline void applyEqual(CarriageMeta& meta, const std::string& equal_name) {
+    meta.equal_name = equal_name;
+    meta.tolerance = equal_name=="Strictly"?kEpsilon:kEpsilonLoose;
+  }
+
+  static inline void applyUpdateFrequency(CarriageMeta& meta, const double& freq) {
+    meta.update_freq = freq<=kLoopRate?freq:kLoopRate;
+    const auto& div = static_cast<uint16_t>(kLoopRate/meta.update_freq);
+    meta.update_div = div>0?div:1;
+  }
+
+  /**
+   * @brief Point this carriage to the shared instance of a metadata, the previous one is released
+   * @param meta the metadata
+   */
+  inline void assignMeta(const CarriageMeta& meta) {
+    const CarriageMeta* next = CarriageMetaTable::intern(meta);
+    CarriageMetaTable::release(meta_);
+    meta_ = next;
+  }
+
+  template<typename U, typename... Args>
+  inline void dispatchCurrent(std::true_type, Args&&... args) {
+    if (value_type_ == ValueTraits<U>::type) {
+      static_cast<Carriage<U>*>(this)->setCurrent(std::forward<Args>(args)...);
+      return;
+    }
+    dispatchCurrent<U>(std::false_type(), std::forward<Args>(args)...);
+  }
+
+  template<typename U, typename... Args>
+  inline void dispatchCurrent(std::false_type, Args&&... args) {
+    const double values[] = {static_cast<double>(args)...};
+    setCurrentValues(values, sizeof...(args));
+  }
+
+  template<typename U>
+  inline std::vector<U> convertTarget(std::true_type) const {
+    if (value_type_ == ValueTraits<U>::type) {
+      return static_cast<const Carriage<U>*>(this)->getTargetVec();
+    }
+    std::vector<U> temp(size());
+    for(size_t i=0;i<temp.size();i++) {temp[i] = ValueTraits<U>::fromDouble(targetValue(i));}
+    return temp;
+  }
+
+  template<typename U>
+  inline std::vector<U> convertTarget(std::false_type) const {
+    std::vector<U> temp(size());
+    for(size_t i=0;i<temp.size();i++) {temp[i] = static_cast<U>(targetValue(i));}
+    return temp;
+  }
+
+  const CarriageMeta* meta_;
+  uint32_t count_;
+  bool is_complete_;
+  bool is_initialized_;
+  int8_t outcome_;
+  ValueType value_type_;
+};
+
+/**
+ * @class Carriage
+ * @brief The class that contructs the base actuator with values of type T, one of double, float, int32_t and Fixed
+ */
+template <typename T>
+class Carriage: public CarriageBase {
+  static_assert(ValueTraits<T>::is_value, "Please use double, float, int32_t or Fixed");
+public:
+
+  /**
+   * @brief The default constructor
+   */  
+  template<typename... Args>
+  Carriage(const std::string& name,
+           const bool& is_complete, 
+           Args&&... args):
+    CarriageBase(name, is_complete, ValueTraits<T>::type),
+    data_(sizeof...(args))
+    {
+      setTarget(std::forward<Args>(args)...);
+      setInitialCurrent();
+    }
+
+  /**
+   * @brief The copy constructor, the copy shares the metadata
+   */  
+  Carriage(const Carriage& c) = default;
+
+  /**
+   * @brief The default destructor
+   */  
+  virtual ~Carriage() = default;
+
+  /**
+   * @brief Deep copy this carriage, the derived actuators override it to copy themselves
+   * @return the copy
+   */  
+  virtual std::shared_ptr<Carriage> clone() const {
+    return std::make_shared<Carriage>(*this);
+  }
+
+  /**
+   * @brief Check the goal in a naive comarison way (conpare current and target with specific criterion)
+   * @return complete or not
+   */ 
+  inline bool naiveCheckGoal() const {
+    return ValueTraits<T>::isWithin(data_.targetData(), data_.currentData(), data_.len, meta().tolerance);
+  }
+
+  /**
+   * @brief Evaluate the goal in place with the comparison of T, the criterion is read from the metadata
+   * @return complete or not
+   */ 
+  virtual bool evaluateGoal() const {
+    if (!meta().is_standard_goal) {return isComplete();}
+    return naiveCheckGoal();
+  }
+
+  /**
+   * @brief set target value and forward it to its data member
+   * @param args the arguments
+   */ 
+  template<typename... Args>
+  void setTarget(Args&&... args) {
+    data_.setTarget(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief set target value and forward it to its data member
+   * @param args the arguments
+   */ 
+  template<typename... Args>
+  void setCurrent(Args&&... args) {
+    data_.setCurrent(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief set initial current value to data member
+   */ 
+  inline void setInitialCurrent() {
+    data_.setInitialCurrent();
   }
 
+  /**
+   * @brief set a single current value in place, without reallocating the data member
+   * @param index the index of the current value
+   * @param value the current value
+   */
+  inline void setCurrentAt(size_t index, const T& value) {
+    data_.setCurrentAt(index, value);
+  }
+
+  /**
+   * @brief set a single target value in place, without reallocating the data member
+   * @param index the index of the target value
+   * @param value the target value
+   */
+  inline void setTargetAt(size_t index, const T& value) {
+    data_.setTargetAt(index, value);
+  }
+
+  virtual size_t size() const {
+    return data_.len;
+  }
+
+  virtual double targetValue(size_t index) const {
+    return ValueTraits<T>::toDouble(data_.getTarget(index));
+  }
+
+  virtual double currentValue(size_t index) const {
+    return ValueTraits<T>::toDouble(data_.getCurrent(index));
+  }
+
+  virtual void setTargetValue(size_t index, const double& value) {
+    data_.setTargetAt(index, ValueTraits<T>::fromDouble(value));
+  }
+
+  virtual void setCurrentValue(size_t index, const double& value) {
+    data_.setCurrentAt(index, ValueTraits<T>::fromDouble(value));
+  }
+
+  virtual void setCurrentValues(const double* values, const size_t& len) {
+    data_.resize(len);
+    for(size_t i=0;i<len;i++) {data_.setCurrentAt(i, ValueTraits<T>::fromDouble(values[i]));}
+  }
+
+  virtual void resetCurrent() {
+    data_.setInitialCurrent();
+  }
+
+  /**
+   * @brief Get the value for the first current
+   * @param index the index of this current value
+   * @return the pointer of the current values
+   */ 
+  inline T getCurrent(size_t index) const {
+    return data_.getCurrent(index);
+  }
+
+  /**
+   * @brief Get the value for the first current
+   * @return the current value
+   */
+  inline T getCurrent() const {
+    return data_.getCurrent();
+  } 
+
+  /**
+   * @brief Get the vector for current values
+   * @return the vector
+   */
+  inline std::vector<T> getCurrentVec() const {
+    return data_.getCurrentVec();
+  } 
+
+  /**
+   * @brief Get the vector for target values
+   * @return the vector
+   */
+  inline std::vector<T> getTargetVec() const {
+    return data_.getTargetVec();
+  } 
+
+  /**
+   * @brief Get target value with specified index
+   * @param index the index
+   * @return the target value
+   */  
+  inline T getTarget(size_t index) const {
+    return data_.getTarget(index);
+  } 
+
+  /**
+   * @brief Get the first target value
+   * @return the target value
+   */  
+  inline T getTarget() const {
+    return data_.getTarget();
+  } 
+
   /**
    * @brief Data getter
    * @return data blob
    */ 
-  inline Blob<T> data() const {
+  inline const Blob<T>& data() const {
     return data_;
   }
 
-  double update_freq_;
-  uint32_t count_;
 private:
-  std::string name_;
-  Blob<T> data_;
-  bool is_complete_;
-  std::string goal_name_;
-  std::string equal_name_;
-  bool is_initialized_;
+  virtual std::shared_ptr<CarriageBase> cloneMember() const {
+    auto copy = clone();
+    if (!copy || typeid(*copy) != typeid(*this)) {
+      std::cerr << FUNC_NAME << "The clone of " << name() << " is sliced, "
+                << "please override clone() in " << typeid(*this).name() << std::endl;
+      return nullptr;
+    }
+    return copy;
+  }
 
-  std::function<bool(const double, const double)> checkEqual;
-  std::function<bool()> checkGoal;
+  Blob<T> data_;
 };
 
+template<typename... Args>
+void CarriageBase::setCurrent(Args&&... args) {
+  typedef typename std::common_type<typename std::decay<Args>::type...>::type U;
+  dispatchCurrent<U>(std::integral_constant<bool, ValueTraits<U>::is_value>(), std::forward<Args>(args)...);
+}
+
+template<typename U>
+std::vector<U> CarriageBase::getTargetVec() const {
+  return convertTarget<U>(std::integral_constant<bool, ValueTraits<U>::is_value>());
+}
+
+static_assert(sizeof(Carriage<double>) <= 64, "Carriage<double> should fit in a cache line");
+
 } // namespace actuator_train
\ No newline at end of file
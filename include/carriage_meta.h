@@ -0,0 +1,78 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace actuator_train {
+
+enum class TimeoutPolicy:int {
+  Skip,   // treat the timed out carriages as complete and move on
+  Abort,  // stop the train
+};
+
+/**
+ * @struct Deadline
+ * @brief The time budget of a carriage, a stage or a train, counted from its activation
+ */
+struct Deadline {
+  uint32_t ms = 0;                           // 0 means no deadline
+  TimeoutPolicy policy = TimeoutPolicy::Abort;
+  bool stop = true;                          // call stop() on the timed out carriages
+};
+
+/**
+ * @struct CarriageMeta
+ * @brief The immutable configuration of a carriage, carriages configured alike share one instance
+ */
+struct CarriageMeta {
+  std::string name;
+  std::string goal_name;
+  std::string equal_name;
+  bool is_standard_goal = true;
+  double tolerance = 0.0;
+  double update_freq = 0.0;
+  uint16_t update_div = 1;                   // loop ticks per update
+  Deadline deadline;
+
+  bool operator<(const CarriageMeta& m) const;
+};
+
+/**
+ * @class CarriageMetaTable
+ * @brief The process wide table the carriage metadata is interned in, an entry is reference counted 
+ *        and freed once the last carriage using it releases it, so the table only holds live configurations
+ */
+class CarriageMetaTable {
+public:
+
+  /**
+   * @brief Get the shared instance equal to a metadata and take a reference to it, it is added if absent, 
+   *        safe to call from any thread
+   * @param meta the metadata
+   * @return the shared instance, valid until the reference is released
+   */
+  static const CarriageMeta* intern(const CarriageMeta& meta);
+
+  /**
+   * @brief Take another reference to a shared instance
+   * @param meta the shared instance
+   */
+  static void acquire(const CarriageMeta* meta);
+
+  /**
+   * @brief Release a reference to a shared instance, it is freed with the last one
+   * @param meta the shared instance
+   */
+  static void release(const CarriageMeta* meta);
+
+  /**
+   * @brief The number of distinct metadata in use
+   * @return the size
+   */
+  static size_t size();
+};
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,172 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace actuator_train {
+
+enum class ValueType:uint8_t {
+  Double,
+  Float,
+  Int32,
+  Fixed,
+};
+
+/**
+ * @brief Round a value to int32, out of range values saturate and NaN becomes 0
+ * @param value the value
+ * @return the rounded value
+ */
+inline int32_t saturateInt32(const double& value) {
+  if (value != value) {return 0;}
+  if (value >= static_cast<double>(std::numeric_limits<int32_t>::max())) {return std::numeric_limits<int32_t>::max();}
+  if (value <= static_cast<double>(std::numeric_limits<int32_t>::min())) {return std::numeric_limits<int32_t>::min();}
+  return static_cast<int32_t>(std::lround(value));
+}
+
+/**
+ * @struct Fixed
+ * @brief A Q16.16 fixed-point value, 16 integer bits and 16 fraction bits in an int32,
+ *        values outside [-32768, 32768) saturate
+ */
+struct Fixed {
+  static constexpr double kScale = 65536.0;
+
+  Fixed() = default;
+  explicit Fixed(const double& value):
+  raw(saturateInt32(value*kScale))
+  {}
+
+  inline operator double() const {
+    return raw/kScale;
+  }
+
+  static inline Fixed fromRaw(const int32_t& r) {
+    Fixed f;
+    f.raw = r;
+    return f;
+  }
+
+  int32_t raw = 0;
+};
+
+/**
+ * @struct ValueTraits
+ * @brief The per value type conversions and goal comparison, only the types specialized below can be carried
+ */
+template <typename T>
+struct ValueTraits {
+  static constexpr bool is_value = false;
+};
+
+template <>
+struct ValueTraits<double> {
+  static constexpr bool is_value = true;
+  static constexpr ValueType type = ValueType::Double;
+
+  static inline double fromDouble(const double& v) {return v;}
+  static inline double toDouble(const double& v) {return v;}
+
+  /**
+   * @brief Check if every current value is within the tolerance of its target, written without early exit so it vectorizes
+   * @param target the target values
+   * @param current the current values
+   * @param len the number of values
+   * @param tolerance the tolerance
+   * @return within or not
+   */
+  static inline bool isWithin(const double* target, const double* current, const size_t& len, const double& tolerance) {
+    bool ret = true;
+    for(size_t i=0;i<len;i++) {ret &= std::fabs(target[i]-current[i]) <= tolerance;}
+    return ret;
+  }
+};
+
+template <>
+struct ValueTraits<float> {
+  static constexpr bool is_value = true;
+  static constexpr ValueType type = ValueType::Float;
+
+  static inline float fromDouble(const double& v) {return static_cast<float>(v);}
+  static inline double toDouble(const float& v) {return v;}
+
+  static inline bool isWithin(const float* target, const float* current, const size_t& len, const double& tolerance) {
+    const float tol = static_cast<float>(tolerance);
+    bool ret = true;
+    for(size_t i=0;i<len;i++) {ret &= std::fabs(target[i]-current[i]) <= tol;}
+    return ret;
+  }
+};
+
+template <>
+struct ValueTraits<int32_t> {
+  static constexpr bool is_value = true;
+  static constexpr ValueType type = ValueType::Int32;
+
+  static inline int32_t fromDouble(const double& v) {return saturateInt32(v);}
+  static inline double toDouble(const int32_t& v) {return v;}
+
+  static inline bool isWithin(const int32_t* target, const int32_t* current, const size_t& len, const double& tolerance) {
+    const int64_t tol = static_cast<int64_t>(std::floor(tolerance));
+    bool ret = true;
+    for(size_t i=0;i<len;i++) {ret &= std::llabs(static_cast<int64_t>(target[i])-current[i]) <= tol;}
+    return ret;
+  }
+};
+
+template <>
+struct ValueTraits<Fixed> {
+  static constexpr bool is_value = true;
+  static constexpr ValueType type = ValueType::Fixed;
+
+  static inline Fixed fromDouble(const double& v) {return Fixed(v);}
+  static inline double toDouble(const Fixed& v) {return v;}
+
+  static inline bool isWithin(const Fixed* target, const Fixed* current, const size_t& len, const double& tolerance) {
+    const int64_t tol = static_cast<int64_t>(std::floor(tolerance*Fixed::kScale));
+    bool ret = true;
+    for(size_t i=0;i<len;i++) {ret &= std::llabs(static_cast<int64_t>(target[i].raw)-current[i].raw) <= tol;}
+    return ret;
+  }
+};
+
+/**
+ * @brief Convert an argument to a value type, floating point arguments go through fromDouble so they saturate
+ * @param value the argument
+ * @return the converted value
+ */
+template <typename T, typename U>
+inline typename std::enable_if<std::is_floating_point<U>::value && ValueTraits<T>::is_value, T>::type
+valueCast(const U& value) {
+  return ValueTraits<T>::fromDouble(value);
+}
+
+template <typename T, typename U>
+inline typename std::enable_if<!(std::is_floating_point<U>::value && ValueTraits<T>::is_value), T>::type
+valueCast(const U& value) {
+  return static_cast<T>(value);
+}
+
+/**
+ * @brief The name of a value type
+ * @param type the value type
+ * @return the name
+ */
+inline const char* valueTypeName(const ValueType& type) {
+  switch (type) {
+    case ValueType::Double: return "double";
+    case ValueType::Float: return "float";
+    case ValueType::Int32: return "int32";
+    case ValueType::Fixed: return "fixed";
+  }
+  return "unknown";
+}
+
+} // namespace actuator_train
\ No newline at end of file
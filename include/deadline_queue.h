@@ -0,0 +1,86 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+namespace actuator_train {
+
+/**
+ * @class DeadlineQueue
+ * @brief A min-heap of timers keyed by their expiry tick, checking for expiry only looks at the top
+ */
+template <typename T>
+class DeadlineQueue {
+public:
+
+  struct Entry {
+    uint64_t expiry;
+    T payload;
+  };
+
+  /**
+   * @brief Reserve the storage so that pushing does not allocate
+   * @param n the number of timers
+   */
+  inline void reserve(const size_t& n) {
+    heap_.reserve(n);
+  }
+
+  /**
+   * @brief Add a timer
+   * @param expiry the tick when the timer expires
+   * @param payload the payload of the timer
+   */
+  inline void push(const uint64_t& expiry, const T& payload) {
+    heap_.push_back(Entry{expiry, payload});
+    std::push_heap(heap_.begin(), heap_.end(), later);
+  }
+
+  /**
+   * @brief Check if the earliest timer has expired
+   * @param now the current tick
+   * @return expired or not
+   */
+  inline bool isExpired(const uint64_t& now) const {
+    return !heap_.empty() && heap_.front().expiry <= now;
+  }
+
+  /**
+   * @brief Remove the earliest timer
+   * @return the earliest timer
+   */
+  inline Entry pop() {
+    std::pop_heap(heap_.begin(), heap_.end(), later);
+    Entry e = heap_.back();
+    heap_.pop_back();
+    return e;
+  }
+
+  /**
+   * @brief Remove all the timers, keep the storage
+   */
+  inline void clear() {
+    heap_.clear();
+  }
+
+  inline bool empty() const {
+    return heap_.empty();
+  }
+
+  inline size_t size() const {
+    return heap_.size();
+  }
+
+private:
+  static inline bool later(const Entry& a, const Entry& b) {
+    return a.expiry > b.expiry;
+  }
+
+  std::vector<Entry> heap_;
+};
+
+} // namespace actuator_train
\ No newline at end of file
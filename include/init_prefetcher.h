@@ -0,0 +1,78 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "carriage_base.h"
+
+namespace actuator_train {
+
+enum class InitState:uint8_t {
+  Idle,
+  Queued,
+  Done
+};
+
+typedef std::vector<std::atomic<uint8_t>> InitStateList;
+
+/**
+ * @class InitPrefetcher
+ * @brief A pool of background workers that run init() of the carriages in upcoming stages
+ */
+class InitPrefetcher {
+public:
+
+  /**
+   * @brief The default constructor, starts the workers
+   * @param workers the number of workers
+   */
+  explicit InitPrefetcher(const size_t& workers);
+
+  /**
+   * @brief The default destructor, drops the queued jobs and joins the workers
+   */
+  virtual ~InitPrefetcher();
+
+  InitPrefetcher(const InitPrefetcher&) = delete;
+  InitPrefetcher& operator=(const InitPrefetcher&) = delete;
+
+  /**
+   * @brief Queue the init() of a carriage, its state becomes Done once init() returns
+   * @param c the carriage
+   * @param states the state list the carriage state lives in
+   * @param idx the index of the carriage state
+   */
+  void submit(const std::shared_ptr<CarriageBase>& c,
+              const std::shared_ptr<InitStateList>& states,
+              const size_t& idx);
+
+  /**
+   * @brief Drop the queued jobs and wait for the running ones, the dropped carriages go back to Idle
+   */
+  void cancel();
+
+private:
+  struct Job {
+    std::shared_ptr<CarriageBase> carriage;
+    std::shared_ptr<InitStateList> states;
+    size_t idx;
+  };
+
+  void work();
+
+  std::vector<std::thread> workers_;
+  std::deque<Job> jobs_;
+  std::mutex mutex_;
+  std::condition_variable job_cv_, idle_cv_;
+  size_t running_;
+  bool is_stopped_;
+};
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,123 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace actuator_train {
+
+static constexpr size_t kPrefaultStackSize = 512*1024;
+
+/**
+ * @struct RealtimeConfig
+ * @brief The real-time settings applied to the ignite thread
+ */
+struct RealtimeConfig {
+  int priority = 0;                       // SCHED_FIFO priority, 0 keeps the default scheduler
+  std::vector<int> cpus;                  // CPUs the ignite thread is pinned to, empty keeps the affinity
+  bool lock_memory = true;                // lock current and future pages with mlockall
+  size_t prefault_stack = kPrefaultStackSize; // stack bytes touched before the first tick
+  bool check_allocation = true;           // count heap allocations made during ticks, needs actuator_train_alloc_check
+};
+
+/**
+ * @struct RealtimeStatus
+ * @brief What was actually applied, a setting that is not permitted falls back to the default with a warning
+ */
+struct RealtimeStatus {
+  bool is_fifo = false;
+  bool is_pinned = false;
+  bool is_memory_locked = false;
+};
+
+/**
+ * @struct RealtimeState
+ * @brief The settings of a thread that applyRealtime replaced, used to put them back
+ */
+struct RealtimeState {
+  bool is_sched_saved = false;
+  int policy = 0;
+  int priority = 0;
+  bool is_affinity_saved = false;
+  std::vector<int> cpus;
+  bool is_memory_locked = false;          // locked by applyRealtime, released on restore
+};
+
+/**
+ * @brief Apply the real-time settings to the calling thread, print a warning for each setting that falls back
+ * @param config the settings
+ * @param previous the replaced settings, for restoreRealtime
+ * @return what was applied
+ */
+RealtimeStatus applyRealtime(const RealtimeConfig& config, RealtimeState& previous);
+
+/**
+ * @brief Put back the settings of the calling thread that applyRealtime replaced. Memory locking is process wide,
+ *        so the memory is only unlocked once no real-time ignite needs it, and never if it was locked before the first one
+ * @param previous the replaced settings
+ */
+void restoreRealtime(const RealtimeState& previous);
+
+/**
+ * @class RealtimeScope
+ * @brief Apply the real-time settings for the lifetime of the scope, they are restored on every return path
+ */
+class RealtimeScope {
+public:
+  RealtimeScope():
+  is_applied_(false)
+  {}
+  ~RealtimeScope() {
+    if (is_applied_) {restoreRealtime(previous_);}
+  }
+
+  RealtimeScope(const RealtimeScope&) = delete;
+  RealtimeScope& operator=(const RealtimeScope&) = delete;
+
+  /**
+   * @brief Apply the settings to the calling thread, the scope must be destroyed on the same thread
+   * @param config the settings
+   * @return what was applied
+   */
+  inline RealtimeStatus apply(const RealtimeConfig& config) {
+    is_applied_ = true;
+    return applyRealtime(config, previous_);
+  }
+
+private:
+  RealtimeState previous_;
+  bool is_applied_;
+};
+
+/**
+ * @brief Touch the given amount of stack so the loop does not page fault on it later
+ * @param bytes the stack size
+ */
+void prefaultStack(const size_t& bytes);
+
+/**
+ * @brief Enable or disable counting the heap allocations made by the calling thread
+ * @param enable enable or not
+ */
+void setAllocationCheck(const bool& enable);
+
+/**
+ * @brief The number of heap allocations counted on the calling thread so far
+ * @return the count
+ */
+uint64_t allocationCount();
+
+/**
+ * @brief Count a heap allocation on the calling thread if counting is enabled, called by the allocation hook
+ */
+void countAllocation();
+
+/**
+ * @brief Mark the allocation hook as installed, called once by actuator_train_alloc_check when it is loaded
+ */
+void installAllocationHook();
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,174 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <string>
+#include <cstdint>
+#include "carriage_base.h"
+
+namespace actuator_train {
+
+static constexpr size_t kBridgeMaxCarriages = 64;
+static constexpr size_t kBridgeMaxValues = 8;
+static constexpr size_t kBridgeNameLen = 32;
+static constexpr uint32_t kBridgeMagic = 0x41545242; // "ATRB"
+static constexpr uint32_t kBridgeVersion = 1;
+
+/**
+ * @struct BridgeSlot
+ * @brief The published state of one carriage in the executing stage
+ */
+struct BridgeSlot {
+  char name[kBridgeNameLen];
+  uint32_t len;
+  uint32_t is_complete;
+  double target[kBridgeMaxValues];
+  double current[kBridgeMaxValues];
+};
+
+/**
+ * @struct BridgeInbox
+ * @brief The inbound current values for one carriage slot, guarded by its own sequence counter
+ */
+struct BridgeInbox {
+  std::atomic<uint64_t> seq;
+  uint64_t stage_idx;
+  uint32_t len;
+  double current[kBridgeMaxValues];
+};
+
+/**
+ * @struct BridgeRegion
+ * @brief The memory layout of the shared region
+ */
+struct BridgeRegion {
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint64_t> seq;
+  uint64_t tick;
+  uint64_t stage_idx;
+  uint32_t is_ignited;
+  uint32_t carriage_size;
+  BridgeSlot slot[kBridgeMaxCarriages];
+  BridgeInbox inbox[kBridgeMaxCarriages];
+};
+
+/**
+ * @struct BridgeView
+ * @brief A consistent local copy of the published state
+ */
+struct BridgeView {
+  uint64_t tick;
+  uint64_t stage_idx;
+  bool is_ignited;
+  uint32_t carriage_size;
+  std::array<BridgeSlot, kBridgeMaxCarriages> slot;
+};
+
+/**
+ * @class ShmBridge
+ * @brief A POSIX shared memory region that publishes the executing stage under a seqlock,
+ *        and receives current values from other processes through per-slot inboxes
+ */
+class ShmBridge {
+public:
+
+  /**
+   * @brief The default constructor
+   * @param name the shared memory object name, e.g. "/actuator_train"
+   */
+  explicit ShmBridge(const std::string& name);
+
+  /**
+   * @brief The default destructor, unmaps the region and unlinks it if this side created it
+   */
+  virtual ~ShmBridge();
+
+  ShmBridge(const ShmBridge&) = delete;
+  ShmBridge& operator=(const ShmBridge&) = delete;
+
+  /**
+   * @brief Create (or truncate) the region, this is what the process owning the train does
+   * @return success or not
+   */
+  bool create();
+
+  /**
+   * @brief Attach to a region created by another process
+   * @return success or not
+   */
+  bool attach();
+
+  /**
+   * @brief Check if the region is mapped
+   * @return mapped or not
+   */
+  inline bool isValid() const {
+    return region_ != nullptr;
+  }
+
+  /**
+   * @brief Start publishing a new state, the readers retry until endPublish is called
+   * @param stage_idx the index of the executing stage
+   * @param tick the loop tick count
+   * @param size the carriage size of the executing stage
+   */
+  void beginPublish(const size_t& stage_idx, const uint64_t& tick, const size_t& size);
+
+  /**
+   * @brief Publish one carriage, must be called between beginPublish and endPublish
+   * @param pos the position of the carriage within the executing stage
+   * @param c the carriage
+   */
+  void publishSlot(const size_t& pos, const CarriageBase& c);
+
+  /**
+   * @brief Publish an empty slot for a carriage that cannot be read yet, it cannot be fed until it is published
+   * @param pos the position of the carriage within the executing stage
+   */
+  void clearSlot(const size_t& pos);
+
+  /**
+   * @brief Finish publishing
+   * @param is_ignited whether the train is still running
+   */
+  void endPublish(const bool& is_ignited);
+
+  /**
+   * @brief Fetch the unseen current values written to the inbox of a slot
+   * @param pos the position of the carriage within the executing stage
+   * @param stage_idx the index of the executing stage, values written for other stages are dropped
+   * @param c the carriage that receives the values
+   * @return whether new values were applied
+   */
+  bool consumeSlot(const size_t& pos, const size_t& stage_idx, CarriageBase& c);
+
+  /**
+   * @brief Read a consistent copy of the published state
+   * @param view the output
+   * @return false if the region is not mapped or no consistent copy could be taken
+   */
+  bool read(BridgeView& view) const;
+
+  /**
+   * @brief Write current values of a carriage in the executing stage, used by the feeding process
+   * @param name the carriage name, compared in the truncated form it is published with
+   * @param values the current values
+   * @param len the number of values
+   * @return false if the region is not mapped, the carriage is not in the executing stage or the slot is being written
+   */
+  bool feedCurrent(const std::string& name, const double* values, const size_t& len);
+
+private:
+  bool map(const bool& is_owner);
+
+  std::string name_;
+  BridgeRegion* region_;
+  bool is_owner_;
+  std::array<uint64_t, kBridgeMaxCarriages> last_seen_;
+};
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,309 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include "train.h"
+
+namespace actuator_train {
+
+/**
+ * @class Stage
+ * @brief A stage of a StaticTrain, the carriages are held by value
+ */
+template <typename... Cs>
+class Stage {
+public:
+  explicit Stage(Cs... cs):
+  carriages(std::move(cs)...)
+  {}
+
+  static constexpr size_t size = sizeof...(Cs);
+
+  std::tuple<Cs...> carriages;
+};
+
+/**
+ * @class StaticTrain
+ * @brief A train whose plan is fixed at compile time, e.g. StaticTrain<Stage<FooActuator, BarActuator>, Stage<BarActuator>>.
+ *        Stage execution is unrolled over the tuples and init()/proc() are called with qualified names,
+ *        so there is no virtual dispatch and no std::function in the loop
+ */
+template <typename... Stages>
+class StaticTrain {
+public:
+  explicit StaticTrain(Stages... stages):
+  stages_(std::move(stages)...),
+  carriage_exec_idx_(0),
+  is_ignited_(false),
+  is_extinguish_(false),
+  is_verbose_(true)
+  {}
+  virtual ~StaticTrain() = default;
+
+  static constexpr size_t stage_size = sizeof...(Stages);
+
+  /**
+   * @brief feed current data to target carriage in current executing stage in this train
+   * @param name the carriage name
+   * @param data the input argument of the carriage
+   */
+  template <typename... Args>
+  void feedCurrent(const std::string& name, Args&&... data) {
+    if (!is_ignited_) {return;}
+    forEachInStage(carriage_exec_idx_, [&](auto& c) {
+      if (c.name() == name) {
+        c.setCurrent(std::forward<Args>(data)...);
+      }
+    });
+  }
+
+  /**
+   * @brief collect the data to target carriage in current executing stage in this train
+   * @param name the carriage name
+   * @param data the input argument of the carriage
+   */
+  template<typename T = double>
+  std::vector<T> collectTarget(const std::string& name) {
+    std::vector<T> temp;
+    if (!is_ignited_) {return temp;}
+    bool is_found = false;
+    forEachInStage(carriage_exec_idx_, [&](auto& c) {
+      if (!is_found && c.name() == name) {
+        temp = c.CarriageBase::template getTargetVec<T>();
+        is_found = true;
+      }
+    });
+    return temp;
+  }
+
+  /**
+   * @brief ignite the train, start running
+   * @param from_idx from which index that the train starts igniting, the default is from beginning(from_idx=0)
+   */
+  IgniteResult ignite(const size_t& from_idx = 0) {
+    if (!prepare(from_idx)) {
+      return IgniteResult::Error;
+    }
+    IgniteResult result = IgniteResult::Success;
+    const auto period = std::chrono::milliseconds(1000/loop_rate_);
+    auto next_tick = std::chrono::steady_clock::now();
+    while(step(result)) {
+      next_tick += period;
+      const auto now = std::chrono::steady_clock::now();
+      if (now > next_tick) {next_tick = now;}
+      std::this_thread::sleep_until(next_tick);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Prepare the train for stepping, ignite calls it before the first tick
+   * @param from_idx from which index that the train starts
+   * @return false if the train cannot be ignited
+   */
+  bool prepare(const size_t& from_idx = 0) {
+    if (from_idx >= stage_size) {
+      std::cout << FUNC_NAME << "Stage " << from_idx << " is out of range!" << std::endl;
+      return false;
+    }
+    is_ignited_ = true;
+    carriage_exec_idx_ = from_idx;
+    if (is_verbose_) {std::cout << FUNC_NAME << "Start." << std::endl;}
+    return true;
+  }
+
+  /**
+   * @brief Run a single tick without sleeping
+   * @param result the result of the train once it stops
+   * @return true while the train is still running
+   */
+  bool step(IgniteResult& result) {
+    if (is_extinguish_) {
+      is_ignited_ = false;
+      is_extinguish_ = false;
+      forEachInStage(carriage_exec_idx_, [](auto& c) {
+        using C = typename std::decay<decltype(c)>::type;
+        c.C::stop();
+      });
+      result = IgniteResult::Fail;
+      return false;
+    }
+    const auto& stage_complete = stepStageAt(carriage_exec_idx_, std::index_sequence_for<Stages...>());
+    if (stage_complete) {
+      if (carriage_exec_idx_>=stage_size-1) {
+        is_ignited_ = false;
+        result = IgniteResult::Success;
+        return false;
+      }
+      carriage_exec_idx_++;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Carriage getter, resolved at compile time
+   * @return the J-th carriage of the I-th stage
+   */
+  template<size_t I, size_t J>
+  inline auto& get() {
+    return std::get<J>(std::get<I>(stages_).carriages);
+  }
+
+  /**
+   * @brief Train size getter
+   * @return The size of current train
+   */
+  inline size_t getTrainSize() const {
+    return stage_size;
+  }
+
+  /**
+   * @brief The index getter of current executed carriage
+   * @return The index
+   */
+  inline size_t getCarriageExecIdx() const {
+    return carriage_exec_idx_;
+  }
+
+  /**
+   * @brief Check if the train has been ignited
+   * @return yes or no
+   */
+  inline bool isTrainIgnited() const {
+    return is_ignited_;
+  }
+
+  /**
+   * @brief Extinguish current train, make it exit silently
+   */
+  inline void extinguish() {
+    if (is_ignited_) {
+      is_extinguish_ = true;
+      while (is_ignited_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    }
+  }
+
+  /**
+   * @brief Enable or disable the progress printing of ignite
+   * @param verbose print or not
+   */
+  inline void setVerbose(const bool& verbose) {
+    is_verbose_ = verbose;
+  }
+
+  const uint32_t loop_rate_ = kLoopRate; // 10 Hz
+
+private:
+
+  /**
+   * @brief Run one tick of a carriage, init() and proc() are called without virtual dispatch
+   * @param c the carriage
+   */
+  template<typename C>
+  inline void tickCarriage(C& c) {
+    if (c.isTimeout()) {
+      return;
+    }
+    if (!c.isInited()) {
+      if (is_verbose_) {std::cout << FUNC_NAME << "-> Stage: " << carriage_exec_idx_ << std::endl;}
+      c.C::init();
+      c.setInit();
+      return;
+    }
+    if (!c.isUpdateDue()) {
+      return;
+    }
+    c.C::proc();
+    c.setComplete(c.C::evaluateGoal());
+  }
+
+  /**
+   * @brief Run one tick of the I-th stage
+   * @return whether the stage is complete
+   */
+  template<size_t I>
+  inline bool stepStage() {
+    auto& stage = std::get<I>(stages_).carriages;
+    return stepCarriages(stage, std::make_index_sequence<std::tuple_size<
+      typename std::decay<decltype(stage)>::type>::value>());
+  }
+
+  template<typename Tuple, size_t... Js>
+  inline bool stepCarriages(Tuple& stage, std::index_sequence<Js...>) {
+    using expander = int[];
+    (void)expander{0, (tickCarriage(std::get<Js>(stage)), 0)...};
+    bool complete = true;
+    (void)expander{0, (complete &= std::get<Js>(stage).isComplete(), 0)...};
+    return complete;
+  }
+
+  /**
+   * @brief Run one tick of the stage with a runtime index, dispatched through a table of unrolled stages
+   * @param idx the index of the stage
+   * @return whether the stage is complete
+   */
+  template<size_t... Is>
+  inline bool stepStageAt(const size_t& idx, std::index_sequence<Is...>) {
+    using StepFn = bool (StaticTrain::*)();
+    static constexpr StepFn table[] = {&StaticTrain::stepStage<Is>...};
+    return (this->*table[idx])();
+  }
+
+  /**
+   * @brief Apply a function to every carriage of the stage with a runtime index
+   * @param idx the index of the stage
+   * @param f the function
+   */
+  template<typename F>
+  inline void forEachInStage(const size_t& idx, F&& f) {
+    forEachInStage(idx, f, std::index_sequence_for<Stages...>());
+  }
+
+  template<typename F, size_t... Is>
+  inline void forEachInStage(const size_t& idx, F& f, std::index_sequence<Is...>) {
+    using expander = int[];
+    (void)expander{0, (idx==Is?(forEachCarriage(std::get<Is>(stages_).carriages, f), 0):0)...};
+  }
+
+  template<typename Tuple, typename F>
+  inline void forEachCarriage(Tuple& stage, F& f) {
+    forEachCarriage(stage, f, std::make_index_sequence<std::tuple_size<Tuple>::value>());
+  }
+
+  template<typename Tuple, typename F, size_t... Js>
+  inline void forEachCarriage(Tuple& stage, F& f, std::index_sequence<Js...>) {
+    using expander = int[];
+    (void)expander{0, (f(std::get<Js>(stage)), 0)...};
+  }
+
+  std::tuple<Stages...> stages_;
+  size_t carriage_exec_idx_;
+  bool is_ignited_, is_extinguish_, is_verbose_;
+};
+
+/**
+ * @brief Make a stage, deducing the carriage types
+ * @param cs the carriages
+ * @return the stage
+ */
+template <typename... Cs>
+inline Stage<typename std::decay<Cs>::type...> makeStage(Cs&&... cs) {
+  return Stage<typename std::decay<Cs>::type...>(std::forward<Cs>(cs)...);
+}
+
+/**
+ * @brief Make a static train, deducing the stage types
+ * @param stages the stages
+ * @return the train
+ */
+template <typename... Stages>
+inline StaticTrain<typename std::decay<Stages>::type...> makeStaticTrain(Stages&&... stages) {
+  return StaticTrain<typename std::decay<Stages>::type...>(std::forward<Stages>(stages)...);
+}
+
+} // namespace actuator_train
\ No newline at end of file
@@ -13,13 +13,22 @@
 #include <thread>
 #include <memory>
 #include "carriage_base.h"
+#include "shm_bridge.h"
+#include "realtime.h"
+#include "deadline_queue.h"
+#include "train_checkpoint.h"
+#include "train_snapshot.h"
+#include "init_prefetcher.h"
 
 namespace actuator_train {
 
-typedef Carriage<double> CarriageMember;
+typedef CarriageBase CarriageMember;
 typedef std::list<std::shared_ptr<CarriageMember>> CarriageUnit;
 typedef std::vector<CarriageUnit> CarriageTrain;
 
+static constexpr uint8_t kDeferredTimeout = 0x01;  // timed out while its prefetched init() was running
+static constexpr uint8_t kDeferredStop = 0x02;     // and stop() is due once init() returns
+
 enum class IgniteResult:int {
   Fail,
   Success,
@@ -28,6 +37,36 @@ enum class IgniteResult:int {
 
 using ignite_result_type = std::underlying_type<IgniteResult>::type;
 
+enum class DeadlineScope:int {
+  Carriage,
+  Stage,
+  Train
+};
+
+/**
+ * @struct DeadlineTimer
+ * @brief The payload of an armed deadline
+ */
+struct DeadlineTimer {
+  DeadlineScope scope;
+  uint64_t generation;       // the stage activation that armed it, stale timers are dropped
+  CarriageMember* carriage;  // only for the carriage scope
+  Deadline deadline;
+};
+
+class Train;
+
+/**
+ * @struct StagePlan
+ * @brief A stage as it was built, before nested trains are flattened
+ */
+struct StagePlan {
+  CarriageUnit carriages;
+  std::vector<std::shared_ptr<Train>> trains;
+  size_t first;  // the first flattened stage
+  size_t size;   // the number of flattened stages
+};
+
 /**
  * @struct Train
  * @brief A train that implement the various actuator functionality
@@ -37,18 +76,77 @@ public:
   Train():
   carriage_exec_idx_(0),
   is_ignited_(false),
-  is_extinguish_(false)
+  is_extinguish_(false),
+  tick_(0),
+  stage_tick_(0),
+  is_verbose_(true),
+  is_realtime_(false),
+  tick_alloc_base_(0),
+  tick_alloc_count_(0),
+  missed_tick_count_(0),
+  stage_generation_(0),
+  outcome_(ExecutionOutcome::SUCCESS),
+  checkpoint_every_(1),
+  publish_version_(0),
+  last_published_idx_(0),
+  prefetch_depth_(0),
+  prefetched_idx_(0),
+  is_resuming_(false),
+  is_checkpoint_due_(false)
   {}
+
+  /**
+   * @brief The copy constructor, it copies the plan like operator= does. The copy gets its own execution state,
+   *        the snapshot, checkpoint, bridge and init prefetch are not shared with the original
+   * @param t the train to copy
+   */
+  Train(const Train& t):
+  Train()
+  {
+    *this = t;
+  }
+
   virtual ~Train() = default;
 
   /**
    * @brief add/register member Carriages
    * @param args target Carriage
+   * @return the added carriage
    */
   template<typename T, typename... Args> 
-  inline void add(Args&&... args) {
-    static_assert(std::is_base_of<Carriage<double>, T>::value, "Please use correct types");
-    this->carriage_.push_back(std::make_shared<T>(std::forward<Args>(args)...));
+  inline std::shared_ptr<T> add(Args&&... args) {
+    static_assert(std::is_base_of<CarriageMember, T>::value, "Please use correct types");
+    auto c = std::make_shared<T>(std::forward<Args>(args)...);
+    this->carriage_.push_back(c);
+    return c;
+  }
+
+  /**
+   * @brief add/register a train as a member of the stage being built, the train is copied deeply.
+   *        The stages of the member train are flattened into this train when the stage is built, and member trains
+   *        of the same stage advance in lockstep. A stage holds either carriages or member trains, since a carriage
+   *        would have to run through every flattened stage. Only the built stages are flattened, so a member train
+   *        with carriages or trains that are not built yet is rejected. The stage deadlines of the member train
+   *        are kept, its train deadline is ignored since the member has no run of its own
+   * @param t the member train
+   * @return success or not
+   */
+  bool addTrain(const Train& t) {
+    if (!t.carriage_.empty() || !t.pending_trains_.empty()) {
+      std::cerr << FUNC_NAME << "Please build the member train before adding it!" << std::endl;
+      return false;
+    }
+    if (t.train_deadline_.ms > 0) {
+      std::cerr << FUNC_NAME << "The train deadline of a member train is ignored, "
+                << "please set stage deadlines instead." << std::endl;
+    }
+    auto member = std::make_shared<Train>();
+    if (!t.clone(*member)) {
+      std::cerr << FUNC_NAME << "The member train cannot be cloned!" << std::endl;
+      return false;
+    }
+    this->pending_trains_.push_back(member);
+    return true;
   }
 
   /**
@@ -67,11 +165,23 @@ public:
    * @return merged train
    */
   Train& operator+(const Train& t) {
-    for(auto& t_carriage:t.getCarriage()) {
+    const size_t offset = this->train_.size();
+    const CarriageUnit carriages = t.getCarriage();
+    const auto trains = t.pending_trains_;
+    const auto plan = t.plan_;
+    const auto stage_deadline = t.stage_deadline_;
+    for(auto& t_carriage:carriages) {
       this->carriage_.push_back(t_carriage);
     }
-    for(auto& t_train:t.getTrain()) {
-      this->train_.push_back(t_train);
+    for(auto& t_train:trains) {
+      this->pending_trains_.push_back(t_train);
+    }
+    for(auto& t_stage:plan) {
+      this->plan_.push_back(t_stage);
+      compileStage(this->plan_.back());
+    }
+    for(size_t i=0;i<stage_deadline.size();i++) {
+      setStageDeadline(offset+i, stage_deadline[i]);
     }
     return *this;
   }
@@ -82,24 +192,46 @@ public:
    * @return merged train
    */
   Train& operator+=(const Train& t) {
-    for(auto& t_carriage:t.getCarriage()) {
+    const size_t offset = this->train_.size();
+    const CarriageUnit carriages = t.getCarriage();
+    const auto trains = t.pending_trains_;
+    const auto plan = t.plan_;
+    const auto stage_deadline = t.stage_deadline_;
+    for(auto& t_carriage:carriages) {
       this->carriage_.push_back(t_carriage);
     }
-    for(auto& t_train:t.getTrain()) {
-      this->train_.push_back(t_train);
+    for(auto& t_train:trains) {
+      this->pending_trains_.push_back(t_train);
+    }
+    for(auto& t_stage:plan) {
+      this->plan_.push_back(t_stage);
+      compileStage(this->plan_.back());
+    }
+    for(size_t i=0;i<stage_deadline.size();i++) {
+      setStageDeadline(offset+i, stage_deadline[i]);
     }
     return *this;
   }
 
   /**
-   * @brief assign target train to this train
+   * @brief assign target train to this train, the snapshot, checkpoint, bridge and init prefetch of this train are kept
    * @param t target train
    * @return updated train
    */
   Train& operator=(const Train& t) {
+    if (this == &t) {return *this;}
+    stopPrefetch();
+    this->init_state_.reset();
+    this->init_offset_.clear();
+    this->deferred_timeout_.clear();
     this->carriage_=t.getCarriage();
+    this->pending_trains_=t.pending_trains_;
+    this->plan_=t.plan_;
     this->train_=t.getTrain();
     this->carriage_exec_idx_=t.getCarriageExecIdx();
+    this->stage_deadline_=t.stage_deadline_;
+    this->train_deadline_=t.train_deadline_;
+    this->is_verbose_=t.is_verbose_;
     return *this;
   }
 
@@ -131,7 +263,7 @@ public:
     auto& current_carriage_ = train_.at(carriage_exec_idx_);
     for(auto& c:current_carriage_) {
       if (c->name() == name) {
-        return c->getTargetVec();
+        return c->getTargetVec<T>();
       }
     }
     return temp;
@@ -142,44 +274,433 @@ public:
    * @param from_idx from which index that the train starts igniting, the default is from beginning(from_idx=0)
    */
   IgniteResult ignite(const size_t& from_idx = 0) {
+    if (!prepare(from_idx)) {
+      return IgniteResult::Error;
+    }
+    RealtimeScope realtime;
+    if (is_realtime_) {
+      realtime_status_ = realtime.apply(realtime_config_);
+    }
+    IgniteResult result = IgniteResult::Success;
+    const auto period = std::chrono::milliseconds(1000/loop_rate_);
+    auto next_tick = std::chrono::steady_clock::now();
+    missed_tick_count_ = 0;
+    while(step(result)) {
+      next_tick += period;
+      const auto now = std::chrono::steady_clock::now();
+      if (now > next_tick) {
+        missed_tick_count_ += (now-next_tick)/period;
+        next_tick = now;
+      }
+      std::this_thread::sleep_until(next_tick);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Prepare the train for stepping, ignite calls it before the first tick
+   * @param from_idx from which index that the train starts
+   * @return false if the train cannot be ignited
+   */
+  bool prepare(const size_t& from_idx = 0) {
     if (train_.empty()) {
       std::cout << FUNC_NAME << "An empty train cannot be ignited!" << std::endl;
-      return IgniteResult::Error;
+      return false;
+    }
+    if (from_idx >= train_.size()) {
+      std::cout << FUNC_NAME << "Stage " << from_idx << " is out of range!" << std::endl;
+      return false;
+    }
+    const bool is_resumed = is_resuming_;
+    is_resuming_ = false;
+    stopPrefetch();
+    if (checkpoint_) {
+      checkpoint_->allocate(checkpointSize()*2);
     }
     is_ignited_ = true;
     carriage_exec_idx_ = from_idx;
-    std::cout << FUNC_NAME << "Start." << std::endl;
-    while(1) {
-      auto& current_carriage_ = train_.at(carriage_exec_idx_);
-      if (is_extinguish_) {
-        is_ignited_ = false;
-        is_extinguish_ = false;
-        for(auto& c:current_carriage_) {c->stop();}  
-        return IgniteResult::Fail;
+    resetTimeout(is_resumed?from_idx+1:from_idx);
+    if (!is_resumed) {
+      tick_ = 0;
+      stage_tick_ = 0;
+    }
+    tick_alloc_count_ = 0;
+    outcome_ = ExecutionOutcome::SUCCESS;
+    size_t timer_size = train_.size()+1;
+    for(const auto& unit:train_) {timer_size += unit.size();}
+    deadline_queue_.clear();
+    deadline_queue_.reserve(timer_size);
+    if (train_deadline_.ms > 0) {
+      deadline_queue_.push(toTicks(train_deadline_.ms), 
+                           DeadlineTimer{DeadlineScope::Train, 0, nullptr, train_deadline_});
+    }
+    activateStage(is_resumed);
+    if (checkpoint_) {
+      writeCheckpoint();
+    }
+    if (snapshot_) {
+      if (!snapshot_->isLayout(train_)) {
+        TrainSnapshot layout;
+        fillSnapshot(layout);
+        snapshot_->reset(layout);
+      }
+      publish_version_++;
+      stage_version_.assign(train_.size(), publish_version_);
+      last_published_idx_ = carriage_exec_idx_;
+      writeSnapshot();
+    }
+    if (prefetcher_) {
+      init_offset_.resize(train_.size());
+      size_t offset = 0;
+      for(size_t s=0;s<train_.size();s++) {
+        init_offset_[s] = offset;
+        offset += train_[s].size();
       }
+      init_state_ = std::make_shared<InitStateList>(offset);
+      deferred_timeout_.assign(offset, 0);
+      prefetched_idx_ = carriage_exec_idx_;
+      prefetchStages();
+    }
+    if (is_verbose_) {std::cout << FUNC_NAME << "Start." << std::endl;}
+    return true;
+  }
+
+  /**
+   * @brief Run a single tick without sleeping, ignite calls it at the loop rate, 
+   *        the evaluator calls it back to back to run the train in virtual time
+   * @param result the result of the train once it stops
+   * @return true while the train is still running
+   */
+  bool step(IgniteResult& result) {
+    beginTickCheck();
+    auto& current_carriage_ = train_.at(carriage_exec_idx_);
+    if (is_extinguish_) {
+      is_ignited_ = false;
+      is_extinguish_ = false;
+      outcome_ = ExecutionOutcome::FAIL;
+      stopPrefetch();
+      size_t pos = initOffset(carriage_exec_idx_);
       for(auto& c:current_carriage_) {
-        if(!c->isInited()) {
-          std::cout << FUNC_NAME << "-> Stage: " << carriage_exec_idx_ << std::endl;
-          c->init();
-          c->setInit();
-          continue;
-        }
-        if (c->count_++%static_cast<uint16_t>(loop_rate_/c->update_freq_)!=0) {
+        if (isInitReturned(*c, pos++)) {c->stop();}
+      }
+      publishState();
+      endTickCheck();
+      result = IgniteResult::Fail;
+      return false;
+    }
+    if (!expireDeadlines()) {
+      is_ignited_ = false;
+      outcome_ = ExecutionOutcome::TIMEOUT;
+      stopPrefetch();
+      size_t pos = initOffset(carriage_exec_idx_);
+      for(auto& c:current_carriage_) {
+        if (isInitReturned(*c, pos++) && !c->isTimeout()) {c->stop();}
+      }
+      if (is_verbose_) {std::cout << FUNC_NAME << "Stage: " << carriage_exec_idx_ << ", timeout." << std::endl;}
+      publishState();
+      endTickCheck();
+      result = IgniteResult::Fail;
+      return false;
+    }
+    consumeBridge();
+    size_t pos = initOffset(carriage_exec_idx_);
+    for(auto& c:current_carriage_) {
+      if(!c->isInited() && prefetcher_) {
+        if ((*init_state_)[pos++].load(std::memory_order_acquire) != static_cast<uint8_t>(InitState::Done)) {
           continue;
         }
-        c->update();
+        c->setInit();
+        if (applyDeferredTimeout(*c, pos-1) || c->isTimeout()) {continue;}
+      } else if (c->isTimeout()) {
+        pos++;
+        continue;
+      } else if(!c->isInited()) {
+        setAllocationCheck(false);
+        if (is_verbose_) {std::cout << FUNC_NAME << "-> Stage: " << carriage_exec_idx_ << std::endl;}
+        c->init();
+        c->setInit();
+        setAllocationCheck(isAllocationChecked());
+        continue;
+      } else {
+        pos++;
       }
-      const auto& stage_complete = checkStageComplete();
-      if (stage_complete) {
-        if (carriage_exec_idx_>=train_.size()-1) {
-          is_ignited_ = false;
-          return IgniteResult::Success;
-        }
-        carriage_exec_idx_++;
+      if (!c->isUpdateDue()) {
+        continue;
+      }
+      c->update();
+    }
+    const auto& stage_complete = checkStageComplete();
+    if (stage_complete) {
+      if (carriage_exec_idx_>=train_.size()-1) {
+        is_ignited_ = false;
+        stopPrefetch();
+        publishState();
+        endTickCheck();
+        result = IgniteResult::Success;
+        return false;
+      }
+      carriage_exec_idx_++;
+      activateStage();
+      prefetchStages();
+    }
+    tick_++;
+    publishState();
+    endTickCheck();
+    return true;
+  }
+
+  /**
+   * @brief Deep copy this train, every carriage is cloned so the copy can run independently
+   * @param t the copy, it is replaced
+   * @return false if a carriage cannot be cloned without slicing
+   */
+  bool clone(Train& t) const {
+    t = Train();
+    for(const auto& c:carriage_) {
+      auto copy = c->clone();
+      if (!copy) {return false;}
+      t.carriage_.push_back(copy);
+    }
+    for(const auto& sub:pending_trains_) {
+      auto copy = std::make_shared<Train>();
+      if (!sub->clone(*copy)) {return false;}
+      t.pending_trains_.push_back(copy);
+    }
+    for(const auto& stage:plan_) {
+      StagePlan cloned_stage;
+      for(const auto& c:stage.carriages) {
+        auto copy = c->clone();
+        if (!copy) {return false;}
+        cloned_stage.carriages.push_back(copy);
+      }
+      for(const auto& sub:stage.trains) {
+        auto copy = std::make_shared<Train>();
+        if (!sub->clone(*copy)) {return false;}
+        cloned_stage.trains.push_back(copy);
+      }
+      t.plan_.push_back(std::move(cloned_stage));
+      t.compileStage(t.plan_.back());
+    }
+    t.carriage_exec_idx_ = carriage_exec_idx_;
+    t.is_verbose_ = is_verbose_;
+    t.stage_deadline_ = stage_deadline_;
+    t.train_deadline_ = train_deadline_;
+    return true;
+  }
+
+  /**
+   * @brief Clear the execution state so the plan runs as if it had just been built, every carriage gets its init and
+   *        complete flags, update count, outcome and currents reset, and the train starts over from the first stage
+   * @return false if the train is running
+   */
+  bool reset() {
+    if (is_ignited_) {
+      std::cerr << FUNC_NAME << "A running train cannot be reset!" << std::endl;
+      return false;
+    }
+    stopPrefetch();
+    init_state_.reset();
+    init_offset_.clear();
+    deferred_timeout_.clear();
+    for(auto& unit:train_) {
+      for(auto& c:unit) {c->reset();}
+    }
+    for(auto& c:carriage_) {c->reset();}
+    for(auto& t:pending_trains_) {t->reset();}
+    carriage_exec_idx_ = 0;
+    tick_ = 0;
+    stage_tick_ = 0;
+    outcome_ = ExecutionOutcome::SUCCESS;
+    return true;
+  }
+
+  /**
+   * @brief Run init() of the carriages in the upcoming stages on background workers while the current stage executes,
+   *        a carriage whose init() has returned is updated in the same tick its stage activates
+   * @param depth the number of upcoming stages to initialize ahead, 0 runs init() inline in the loop
+   * @param workers the number of background workers
+   */
+  inline void setInitPrefetch(const size_t& depth, const size_t& workers = 1) {
+    stopPrefetch();
+    prefetch_depth_ = depth;
+    prefetcher_ = depth>0?std::make_shared<InitPrefetcher>(workers):nullptr;
+  }
+
+  /**
+   * @brief Publish a snapshot of all stages every tick while running, so that observers 
+   *        on other threads can read a consistent view through snapshot() without locks or copies
+   */
+  inline void enableSnapshot() {
+    if (!snapshot_) {snapshot_ = std::make_shared<SnapshotRing>();}
+  }
+
+  /**
+   * @brief Pin the latest published snapshot, it stays unchanged until the handle is released, 
+   *        safe to call from any thread while the train is running
+   * @return the handle, invalid if snapshots are not enabled or the train has not been ignited yet
+   */
+  inline SnapshotRing::Handle snapshot() const {
+    if (!snapshot_) {return SnapshotRing::Handle();}
+    return snapshot_->acquire();
+  }
+
+  /**
+   * @brief Keep a snapshot of the execution state while running, 
+   *        the snapshot is written into a double buffer so checkpoint() never pauses the loop
+   * @param every_n_ticks how often the snapshot is refreshed
+   */
+  inline void enableCheckpoint(const uint32_t& every_n_ticks = 1) {
+    checkpoint_every_ = every_n_ticks>0?every_n_ticks:1;
+    if (!checkpoint_) {checkpoint_ = std::make_shared<CheckpointBuffer>();}
+  }
+
+  /**
+   * @brief Take a compact binary snapshot of the execution state(stage index, carriage flags, counters, 
+   *        targets and currents), safe to call from another thread while the train is running
+   * @param out the snapshot
+   * @return success or not
+   */
+  bool checkpoint(std::vector<uint8_t>& out) const {
+    if (is_ignited_) {
+      if (!checkpoint_) {
+        std::cerr << FUNC_NAME << "Please enable checkpoint before ignite!" << std::endl;
+        return false;
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000/loop_rate_));
+      return checkpoint_->read(out);
+    }
+    out.assign(checkpointSize(), 0);
+    ByteWriter writer(out.data(), out.size());
+    serialize(writer);
+    return !writer.isOverflow();
+  }
+
+  /**
+   * @brief Restore the execution state from a snapshot taken on a train with the same plan, 
+   *        call resume() afterwards to continue where the snapshot was taken
+   * @param in the snapshot
+   * @return success or not
+   */
+  bool restore(const std::vector<uint8_t>& in) {
+    if (is_ignited_) {
+      std::cerr << FUNC_NAME << "A running train cannot be restored!" << std::endl;
+      return false;
+    }
+    if (!deserialize(in, false)) {
+      std::cerr << FUNC_NAME << "The checkpoint does not match this train!" << std::endl;
+      return false;
+    }
+    stopPrefetch();
+    init_state_.reset();
+    init_offset_.clear();
+    deferred_timeout_.clear();
+    deserialize(in, true);
+    return true;
+  }
+
+  /**
+   * @brief Continue from the stage index and tick of the restored snapshot, initialized carriages are not initialized again.
+   *        The train, stage and carriage deadlines keep counting from where the snapshot was taken,
+   *        so they only get their remaining budget
+   * @return the ignite result
+   */
+  inline IgniteResult resume() {
+    is_resuming_ = true;
+    return ignite(carriage_exec_idx_);
+  }
+
+  /**
+   * @brief Set the deadline of a stage, counted from the activation of the stage,
+   *        on expiry the incomplete carriages are timed out
+   * @param idx the index of the stage
+   * @param deadline the deadline
+   */
+  inline void setStageDeadline(const size_t& idx, const Deadline& deadline) {
+    if (stage_deadline_.size() <= idx) {stage_deadline_.resize(idx+1);}
+    stage_deadline_[idx] = deadline;
+  }
+
+  /**
+   * @brief Set the deadline of the whole train, counted from the ignition, the train is always aborted on expiry
+   * @param deadline the deadline
+   */
+  inline void setTrainDeadline(const Deadline& deadline) {
+    train_deadline_ = deadline;
+    train_deadline_.policy = TimeoutPolicy::Abort;
+  }
+
+  /**
+   * @brief The outcome of the last ignite, TIMEOUT if a deadline aborted it
+   * @return the outcome
+   */
+  inline ExecutionOutcome getOutcome() const {
+    return outcome_;
+  }
+
+  /**
+   * @brief Enable or disable the progress printing of ignite
+   * @param verbose print or not
+   */
+  inline void setVerbose(const bool& verbose) {
+    is_verbose_ = verbose;
+  }
+
+  /**
+   * @brief The tick count since the last ignite, a resumed ignite continues the restored count
+   * @return the count
+   */
+  inline uint64_t getTick() const {
+    return tick_;
+  }
+
+  /**
+   * @brief Attach a shared memory bridge, the executing stage is published to it every tick
+   *        and the current values written by other processes are fed from it
+   * @param bridge a created bridge, or nullptr to detach
+   * @return false if the bridge is not mapped
+   */
+  inline bool attachBridge(const std::shared_ptr<ShmBridge>& bridge) {
+    if (bridge && !bridge->isValid()) {
+      std::cerr << FUNC_NAME << "Please create the bridge before attaching it!" << std::endl;
+      return false;
     }
-    return IgniteResult::Success;
+    bridge_ = bridge;
+    return true;
+  }
+
+  /**
+   * @brief Run the next ignite in real-time mode, the settings are applied to the thread calling ignite
+   *        and restored when ignite returns, a setting that is not permitted falls back to the default with a warning
+   * @param config the real-time settings
+   */
+  inline void setRealtime(const RealtimeConfig& config) {
+    realtime_config_ = config;
+    is_realtime_ = true;
+  }
+
+  /**
+   * @brief What the last real-time ignite actually applied
+   * @return the status
+   */
+  inline RealtimeStatus getRealtimeStatus() const {
+    return realtime_status_;
+  }
+
+  /**
+   * @brief The number of heap allocations made inside ticks during the last real-time ignite,
+   *        the carriage initialization is not counted
+   * @return the count
+   */
+  inline uint64_t getTickAllocationCount() const {
+    return tick_alloc_count_;
+  }
+
+  /**
+   * @brief The number of ticks the last ignite skipped because a tick overran its period,
+   *        the late tick runs at once and the loop is re-anchored to it instead of catching up
+   * @return the count
+   */
+  inline uint64_t getMissedTickCount() const {
+    return missed_tick_count_;
   }
 
   /**
@@ -202,7 +723,7 @@ public:
    * @brief Carriage getter
    * @return Current carriage
    */
-  inline CarriageUnit getCarriage() const {
+  inline const CarriageUnit& getCarriage() const {
     return carriage_;
   }
 
@@ -210,10 +731,19 @@ public:
    * @brief Train getter
    * @return Current train
    */
-  inline CarriageTrain getTrain() const {
+  inline const CarriageTrain& getTrain() const {
     return train_;
   }
 
+  /**
+   * @brief Stage getter, without copying the stage
+   * @param idx the index of the stage
+   * @return The stage
+   */
+  inline const CarriageUnit& getStage(const size_t& idx) const {
+    return train_.at(idx);
+  }
+
   /**
    * @brief The index getter of current executed carriage
    * @return The index
@@ -257,12 +787,22 @@ public:
    * @return success or not
    */
   bool build() {
-    if (carriage_.empty()) {
+    if (carriage_.empty() && pending_trains_.empty()) {
       std::cerr << FUNC_NAME << "An empty carriage cannot be built!" << std::endl;
       return false;
     }
-    train_.push_back(std::move(carriage_));
+    if (!carriage_.empty() && !pending_trains_.empty()) {
+      std::cerr << FUNC_NAME << "A stage cannot mix carriages and member trains, "
+                << "please build them as separate stages!" << std::endl;
+      return false;
+    }
+    StagePlan stage;
+    stage.carriages = std::move(carriage_);
+    stage.trains = std::move(pending_trains_);
     carriage_.clear();
+    pending_trains_.clear();
+    plan_.push_back(std::move(stage));
+    compileStage(plan_.back());
     return true;
   }
 
@@ -271,26 +811,53 @@ public:
    */
   inline void clearCarriage() {
     carriage_.clear();
+    pending_trains_.clear();
+  }
+
+  /**
+   * @brief Plan getter, the stages as they were built with their member trains
+   * @return The plan
+   */
+  inline const std::vector<StagePlan>& getPlan() const {
+    return plan_;
   }
 
   /**
-   * @brief Observe all the information(carriage members and their attributes), and print them out
+   * @brief Observe all the information(carriage members and their attributes), and print them out,
+   *        a running train is observed through its latest snapshot if snapshots are enabled
    */
-  void observeTrain() {
+  void observeTrain() const {
+    if (is_ignited_) {
+      const auto& handle = snapshot();
+      if (handle.isValid()) {
+        observeSnapshot(*handle);
+        return;
+      }
+    }
+    TrainSnapshot snapshot;
+    fillSnapshot(snapshot);
+    observeSnapshot(snapshot);
+  }
+
+  /**
+   * @brief Print a snapshot out
+   * @param snapshot the snapshot
+   */
+  static void observeSnapshot(const TrainSnapshot& snapshot) {
     std::ostringstream oss;
     oss << "--------------------------------------" <<
     "------------------------------------------" << std::endl;
     oss << "{Train summary}" << std::endl;
-    for(CarriageTrain::iterator it=train_.begin();it!=train_.end();++it) {
-      oss << "[ Stage " << std::distance(train_.begin(), it) << " ]" <<  std::endl;
-      for(const auto& c:*it) {
-        oss << "  [Actuator]:" << c->name() 
-            << ", [Goal]:" << c->goalName() 
-            << ", [Criterion]:" << c->equalName()
+    for(size_t s=0;s<snapshot.stages.size();s++) {
+      oss << "[ Stage " << s << " ]" <<  std::endl;
+      for(const auto& c:snapshot.stages[s]) {
+        oss << "  [Actuator]:" << c.name 
+            << ", [Goal]:" << c.goal_name 
+            << ", [Criterion]:" << c.equal_name
             << ", [Target]:";
-        for(size_t i=0;i<c->data().len;i++) {
-          oss << c->data().getTarget(i);
-          if (i<c->data().len-1) {oss << ", ";}
+        for(size_t i=0;i<c.target.size();i++) {
+          oss << c.target[i];
+          if (i<c.target.size()-1) {oss << ", ";}
         }
         oss << std::endl;
       }
@@ -310,15 +877,21 @@ private:
    */
   bool checkStageComplete() {
     bool complete = true;
-    std::string not_complete_list = "";
     auto& current_carriage_ = train_.at(carriage_exec_idx_);
+    size_t pos = initOffset(carriage_exec_idx_);
     for(auto& c:current_carriage_) {
-      complete &= c->isComplete();
-      if (!c->isComplete()) {
-        not_complete_list += c->name() +", ";
+      if (isInitPending(pos)) {
+        if (!isTimeoutDeferred(pos++)) {return false;}
+        continue;
       }
+      pos++;
+      complete &= c->isComplete();
     }
     // if (!complete) {
+    //   std::string not_complete_list = "";
+    //   for(auto& c:current_carriage_) {
+    //     if (!c->isComplete()) {not_complete_list += c->name() +", ";}
+    //   }
     //   not_complete_list = not_complete_list.substr(0, not_complete_list.size()-1);
     //   std::cout << FUNC_NAME << "Stage: " << carriage_exec_idx_ << 
     //   ", Wait for Actuator [" << not_complete_list << "] to complete .." << std::endl;
@@ -328,10 +901,538 @@ private:
     return complete;
   }
 
+  /**
+   * @brief Queue init() of the carriages up to prefetch_depth_ stages ahead of the executing one
+   */
+  void prefetchStages() {
+    if (!prefetcher_) {return;}
+    setAllocationCheck(false);
+    const size_t last = carriage_exec_idx_+prefetch_depth_<train_.size()-1?
+                        carriage_exec_idx_+prefetch_depth_:train_.size()-1;
+    for(size_t s=prefetched_idx_;s<=last;s++) {
+      size_t pos = init_offset_[s];
+      for(const auto& c:train_[s]) {
+        if (!c->isInited() && 
+            (*init_state_)[pos].load() == static_cast<uint8_t>(InitState::Idle)) {
+          prefetcher_->submit(c, init_state_, pos);
+        }
+        pos++;
+      }
+    }
+    prefetched_idx_ = last+1>prefetched_idx_?last+1:prefetched_idx_;
+    setAllocationCheck(isAllocationChecked());
+  }
+
+  /**
+   * @brief The position of the first carriage of a stage in the init state list
+   * @param idx the index of the stage
+   * @return the position
+   */
+  inline size_t initOffset(const size_t& idx) const {
+    return prefetcher_ && idx < init_offset_.size()?init_offset_[idx]:0;
+  }
+
+  /**
+   * @brief Check if a prefetched init() is queued or running, the loop must not touch such a carriage
+   * @param pos the position of the carriage in the init state list
+   * @return pending or not
+   */
+  inline bool isInitPending(const size_t& pos) const {
+    return prefetcher_ && init_state_ && pos < init_state_->size() &&
+           (*init_state_)[pos].load(std::memory_order_acquire) == static_cast<uint8_t>(InitState::Queued);
+  }
+
+  /**
+   * @brief Check if init() of a carriage has returned, inline or on a prefetch worker
+   * @param c the carriage
+   * @param pos the position of the carriage in the init state list
+   * @return returned or not
+   */
+  inline bool isInitReturned(const CarriageMember& c, const size_t& pos) const {
+    return c.isInited() || (prefetcher_ && init_state_ && pos < init_state_->size() &&
+           (*init_state_)[pos].load(std::memory_order_acquire) == static_cast<uint8_t>(InitState::Done));
+  }
+
+  /**
+   * @brief Check if any prefetched init() is queued or running
+   * @return in flight or not
+   */
+  inline bool isInitInFlight() const {
+    if (!prefetcher_ || !init_state_) {return false;}
+    for(size_t i=0;i<init_state_->size();i++) {
+      if (isInitPending(i)) {return true;}
+    }
+    return false;
+  }
+
+  /**
+   * @brief Drop the queued init() jobs and wait for the running ones, the carriages whose init() has returned
+   *        are marked as initialized so it is not run again, and get the timeouts deferred while it was running
+   */
+  inline void stopPrefetch() {
+    if (!prefetcher_) {return;}
+    setAllocationCheck(false);
+    prefetcher_->cancel();
+    setAllocationCheck(isAllocationChecked());
+    if (!init_state_) {return;}
+    for(size_t s=0;s<train_.size() && s<init_offset_.size();s++) {
+      size_t pos = init_offset_[s];
+      for(auto& c:train_[s]) {
+        if (isInitReturned(*c, pos)) {
+          c->setInit();
+          applyDeferredTimeout(*c, pos);
+        }
+        pos++;
+      }
+    }
+  }
+
+  /**
+   * @brief Convert milliseconds to loop ticks, rounding up
+   * @param ms the milliseconds
+   * @return the ticks
+   */
+  inline uint64_t toTicks(const uint32_t& ms) const {
+    const uint64_t ticks = (static_cast<uint64_t>(ms)*loop_rate_+999)/1000;
+    return ticks>0?ticks:1;
+  }
+
+  /**
+   * @brief Arm the deadlines of the executing stage and its carriages, the timers of the previous stage become stale
+   * @param is_resumed keep the restored activation tick of the stage instead of the current one
+   */
+  void activateStage(const bool& is_resumed = false) {
+    stage_generation_++;
+    if (!is_resumed) {stage_tick_ = tick_;}
+    if (carriage_exec_idx_ < stage_deadline_.size() && stage_deadline_[carriage_exec_idx_].ms > 0) {
+      const auto& deadline = stage_deadline_[carriage_exec_idx_];
+      deadline_queue_.push(stage_tick_+toTicks(deadline.ms), 
+                           DeadlineTimer{DeadlineScope::Stage, stage_generation_, nullptr, deadline});
+    }
+    for(auto& c:train_.at(carriage_exec_idx_)) {
+      const auto& deadline = c->deadline();
+      if (deadline.ms > 0) {
+        deadline_queue_.push(stage_tick_+toTicks(deadline.ms), 
+                             DeadlineTimer{DeadlineScope::Carriage, stage_generation_, c.get(), deadline});
+      }
+    }
+  }
+
+  /**
+   * @brief Clear the timeouts left by a previous ignite, so the carriages of the stages about to run are updated again.
+   *        A resumed ignite keeps the restored outcomes of the stage it resumes
+   * @param from_idx the first stage to clear
+   */
+  void resetTimeout(const size_t& from_idx) {
+    for(size_t s=from_idx;s<train_.size();s++) {
+      for(auto& c:train_[s]) {
+        if (c->isTimeout()) {
+          c->setOutcome(ExecutionOutcome::SUCCESS);
+          c->setComplete(false);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Time out a carriage, stop() is only called once its init() has returned
+   * @param c the carriage
+   * @param pos the position of the carriage in the init state list
+   * @param deadline the expired deadline
+   */
+  inline void timeoutCarriage(CarriageMember& c, const size_t& pos, const Deadline& deadline) {
+    if (deadline.stop && isInitReturned(c, pos)) {c.stop();}
+    c.setTimeout();
+  }
+
+  /**
+   * @brief Time out a carriage whose prefetched init() is still running, the carriage is not touched until
+   *        init() returns, but its stage no longer waits for it
+   * @param pos the position of the carriage in the init state list
+   * @param deadline the expired deadline
+   */
+  inline void deferTimeout(const size_t& pos, const Deadline& deadline) {
+    deferred_timeout_[pos] |= kDeferredTimeout|(deadline.stop?kDeferredStop:0);
+  }
+
+  /**
+   * @brief Check if the timeout of a carriage is deferred until its init() returns
+   * @param pos the position of the carriage in the init state list
+   * @return deferred or not
+   */
+  inline bool isTimeoutDeferred(const size_t& pos) const {
+    return pos < deferred_timeout_.size() && deferred_timeout_[pos] != 0;
+  }
+
+  /**
+   * @brief Apply a deferred timeout, once init() of the carriage has returned
+   * @param c the carriage
+   * @param pos the position of the carriage in the init state list
+   * @return whether a timeout was applied
+   */
+  inline bool applyDeferredTimeout(CarriageMember& c, const size_t& pos) {
+    if (!isTimeoutDeferred(pos)) {return false;}
+    if (deferred_timeout_[pos]&kDeferredStop) {c.stop();}
+    c.setTimeout();
+    deferred_timeout_[pos] = 0;
+    return true;
+  }
+
+  /**
+   * @brief Pop the expired deadlines and run their policies, a carriage whose prefetched init() is still running
+   *        times out like the others, its timeout is applied once init() returns
+   * @return false if the train has to be aborted
+   */
+  bool expireDeadlines() {
+    while (deadline_queue_.isExpired(tick_)) {
+      const auto timer = deadline_queue_.pop().payload;
+      if (timer.scope != DeadlineScope::Train && timer.generation != stage_generation_) {
+        continue;
+      }
+      if (timer.scope == DeadlineScope::Train) {
+        return false;
+      } else if (timer.scope == DeadlineScope::Stage) {
+        size_t pos = initOffset(carriage_exec_idx_);
+        for(auto& c:train_.at(carriage_exec_idx_)) {
+          if (isInitPending(pos)) {
+            deferTimeout(pos, timer.deadline);
+          } else if (!c->isComplete()) {
+            timeoutCarriage(*c, pos, timer.deadline);
+          }
+          pos++;
+        }
+      } else {
+        size_t pos = initOffset(carriage_exec_idx_);
+        for(const auto& c:train_.at(carriage_exec_idx_)) {
+          if (c.get() == timer.carriage) {break;}
+          pos++;
+        }
+        if (isInitPending(pos)) {
+          deferTimeout(pos, timer.deadline);
+        } else if (!timer.carriage->isComplete()) {
+          timeoutCarriage(*timer.carriage, pos, timer.deadline);
+        } else {
+          continue;
+        }
+      }
+      if (timer.deadline.policy == TimeoutPolicy::Abort) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Check if heap allocations are counted in ticks
+   * @return yes or no
+   */
+  inline bool isAllocationChecked() const {
+    return is_realtime_ && realtime_config_.check_allocation;
+  }
+
+  /**
+   * @brief Start counting heap allocations of a tick
+   */
+  inline void beginTickCheck() {
+    if (!isAllocationChecked()) {return;}
+    tick_alloc_base_ = allocationCount();
+    setAllocationCheck(true);
+  }
+
+  /**
+   * @brief Stop counting heap allocations of a tick and report them
+   */
+  void endTickCheck() {
+    if (!isAllocationChecked()) {return;}
+    setAllocationCheck(false);
+    const uint64_t count = allocationCount()-tick_alloc_base_;
+    if (count > 0) {
+      tick_alloc_count_ += count;
+      std::cerr << FUNC_NAME << "Stage: " << carriage_exec_idx_ << ", tick: " << tick_
+                << ", heap allocations: " << count << std::endl;
+    }
+  }
+
+  /**
+   * @brief Publish the state of this tick to the attached observers
+   */
+  inline void publishState() {
+    publishBridge();
+    if (checkpoint_ && (is_checkpoint_due_ || tick_%checkpoint_every_==0 || !is_ignited_)) {
+      is_checkpoint_due_ = isInitInFlight();
+      if (!is_checkpoint_due_) {writeCheckpoint();}
+    }
+    if (snapshot_) {
+      writeSnapshot();
+    }
+  }
+
+  /**
+   * @brief Flatten a built stage into the execution schedule. The member trains are already flat,
+   *        so their i-th stages are merged with each other, a stage without member trains is kept as it is.
+   *        Empty stages are dropped and the stage deadlines of the member trains are kept, the tightest one wins,
+   *        the train deadlines of the member trains are ignored
+   * @param stage the built stage, its flattened range is recorded in it
+   */
+  void compileStage(StagePlan& stage) {
+    stage.first = train_.size();
+    size_t depth = 1;
+    for(const auto& t:stage.trains) {
+      depth = t->train_.size()>depth?t->train_.size():depth;
+    }
+    for(size_t i=0;i<depth;i++) {
+      CarriageUnit unit;
+      if (i == 0) {unit = stage.carriages;}
+      Deadline deadline;
+      for(const auto& t:stage.trains) {
+        if (i >= t->train_.size()) {continue;}
+        unit.insert(unit.end(), t->train_[i].begin(), t->train_[i].end());
+        if (i < t->stage_deadline_.size() && t->stage_deadline_[i].ms > 0 && 
+            (deadline.ms == 0 || t->stage_deadline_[i].ms < deadline.ms)) {
+          deadline = t->stage_deadline_[i];
+        }
+      }
+      if (unit.empty()) {continue;}
+      if (deadline.ms > 0) {setStageDeadline(train_.size(), deadline);}
+      train_.push_back(std::move(unit));
+    }
+    stage.size = train_.size()-stage.first;
+  }
+
+  /**
+   * @brief Copy all the stages into a snapshot, including the names
+   * @param snapshot the output
+   */
+  void fillSnapshot(TrainSnapshot& snapshot) const {
+    snapshot.tick = tick_;
+    snapshot.stage_idx = carriage_exec_idx_;
+    snapshot.is_ignited = is_ignited_;
+    snapshot.stages.resize(train_.size());
+    for(size_t s=0;s<train_.size();s++) {
+      auto& views = snapshot.stages[s];
+      views.resize(train_[s].size());
+      size_t i = 0;
+      for(const auto& c:train_[s]) {
+        auto& v = views[i++];
+        v.name = c->name();
+        v.goal_name = c->goalName();
+        v.equal_name = c->equalName();
+        v.type = c->valueType();
+        fillView(*c, v);
+      }
+    }
+  }
+
+  /**
+   * @brief Copy the values and flags of a carriage, the storage of the view is reused
+   * @param c the carriage
+   * @param v the view
+   */
+  static inline void fillView(const CarriageMember& c, CarriageView& v) {
+    v.target.resize(c.size());
+    v.current.resize(c.size());
+    for(size_t i=0;i<c.size();i++) {
+      v.target[i] = c.targetValue(i);
+      v.current[i] = c.currentValue(i);
+    }
+    v.is_complete = c.isComplete();
+    v.is_inited = c.isInited();
+    v.outcome = c.outcome();
+  }
+
+  /**
+   * @brief Publish a snapshot, only the stages that ran since a slot was last written are copied into it
+   */
+  void writeSnapshot() {
+    publish_version_++;
+    const size_t first = last_published_idx_<carriage_exec_idx_?last_published_idx_:carriage_exec_idx_;
+    for(size_t s=first;s<=carriage_exec_idx_;s++) {stage_version_[s] = publish_version_;}
+    last_published_idx_ = carriage_exec_idx_;
+
+    std::vector<uint64_t>* versions = nullptr;
+    auto* snapshot = snapshot_->beginWrite(versions);
+    if (snapshot == nullptr) {return;}
+    snapshot->tick = tick_;
+    snapshot->stage_idx = carriage_exec_idx_;
+    snapshot->is_ignited = is_ignited_;
+    for(size_t s=0;s<train_.size();s++) {
+      if ((*versions)[s] >= stage_version_[s]) {continue;}
+      size_t i = 0;
+      size_t pos = initOffset(s);
+      for(const auto& c:train_[s]) {
+        if (!isInitPending(pos++)) {fillView(*c, snapshot->stages[s][i]);}
+        i++;
+      }
+      (*versions)[s] = publish_version_;
+    }
+    snapshot_->endWrite();
+  }
+
+  /**
+   * @brief Write a snapshot into the checkpoint buffer
+   */
+  inline void writeCheckpoint() {
+    auto writer = checkpoint_->beginWrite();
+    serialize(writer);
+    checkpoint_->endWrite(writer);
+  }
+
+  /**
+   * @brief The size of a snapshot in bytes
+   * @return the size
+   */
+  size_t checkpointSize() const {
+    size_t size = sizeof(uint32_t)+sizeof(uint16_t)+sizeof(uint32_t)*2+sizeof(uint64_t)*2;
+    for(const auto& unit:train_) {
+      size += sizeof(uint32_t);
+      for(const auto& c:unit) {
+        size += sizeof(uint16_t)+c->name().size()+sizeof(uint8_t)*2+sizeof(uint32_t)
+                +sizeof(uint16_t)+sizeof(uint8_t)+sizeof(double)*2*c->size();
+      }
+    }
+    return size;
+  }
+
+  /**
+   * @brief Write the execution state
+   * @param w the writer
+   */
+  void serialize(ByteWriter& w) const {
+    w.write(kCheckpointMagic);
+    w.write(kCheckpointVersion);
+    w.write(static_cast<uint32_t>(train_.size()));
+    w.write(static_cast<uint32_t>(carriage_exec_idx_));
+    w.write(static_cast<uint64_t>(tick_));
+    w.write(static_cast<uint64_t>(stage_tick_));
+    for(size_t s=0;s<train_.size();s++) {
+      const auto& unit = train_[s];
+      w.write(static_cast<uint32_t>(unit.size()));
+      size_t pos = initOffset(s);
+      for(const auto& c:unit) {
+        w.writeString(c->name());
+        w.write(static_cast<uint8_t>(isInitReturned(*c, pos++)|(c->isComplete()<<1)));
+        w.write(static_cast<int8_t>(c->outcome()));
+        w.write(c->updateCount());
+        w.write(static_cast<uint16_t>(c->size()));
+        w.write(static_cast<uint8_t>(c->valueType()));
+        for(size_t i=0;i<c->size();i++) {w.write(c->targetValue(i));}
+        for(size_t i=0;i<c->size();i++) {w.write(c->currentValue(i));}
+      }
+    }
+  }
+
+  /**
+   * @brief Read the execution state
+   * @param in the snapshot
+   * @param apply false only validates the snapshot against this train
+   * @return whether the snapshot matches this train
+   */
+  bool deserialize(const std::vector<uint8_t>& in, const bool& apply) {
+    ByteReader r(in);
+    if (r.read<uint32_t>() != kCheckpointMagic || r.read<uint16_t>() != kCheckpointVersion) {return false;}
+    if (r.read<uint32_t>() != train_.size()) {return false;}
+    const size_t exec_idx = r.read<uint32_t>();
+    const uint64_t tick = r.read<uint64_t>();
+    const uint64_t stage_tick = r.read<uint64_t>();
+    if (exec_idx >= train_.size() || stage_tick > tick) {return false;}
+    for(auto& unit:train_) {
+      if (r.read<uint32_t>() != unit.size()) {return false;}
+      for(auto& c:unit) {
+        if (r.readString() != c->name()) {return false;}
+        const auto& flags = r.read<uint8_t>();
+        const auto& outcome = r.read<int8_t>();
+        const auto& count = r.read<uint32_t>();
+        if (r.read<uint16_t>() != c->size()) {return false;}
+        if (r.read<uint8_t>() != static_cast<uint8_t>(c->valueType())) {return false;}
+        for(size_t i=0;i<c->size();i++) {
+          const auto& target = r.read<double>();
+          if (apply) {c->setTargetValue(i, target);}
+        }
+        for(size_t i=0;i<c->size();i++) {
+          const auto& current = r.read<double>();
+          if (apply) {c->setCurrentValue(i, current);}
+        }
+        if (apply) {
+          c->setInit(flags&1);
+          c->setComplete(flags&2);
+          c->setOutcome(static_cast<ExecutionOutcome>(outcome));
+          c->setUpdateCount(count);
+        }
+      }
+    }
+    if (!r.isValid() || !r.isEnd()) {return false;}
+    if (apply) {
+      carriage_exec_idx_ = exec_idx;
+      tick_ = tick;
+      stage_tick_ = stage_tick;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Feed the current values written to the bridge into the executing stage
+   */
+  void consumeBridge() {
+    if (!bridge_) {return;}
+    size_t pos = 0;
+    size_t init_pos = initOffset(carriage_exec_idx_);
+    for(auto& c:train_.at(carriage_exec_idx_)) {
+      if (!isInitPending(init_pos++)) {bridge_->consumeSlot(pos, carriage_exec_idx_, *c);}
+      pos++;
+    }
+  }
+
+  /**
+   * @brief Publish the executing stage to the bridge
+   */
+  void publishBridge() {
+    if (!bridge_) {return;}
+    const auto& current_carriage_ = train_.at(carriage_exec_idx_);
+    bridge_->beginPublish(carriage_exec_idx_, tick_, current_carriage_.size());
+    size_t pos = 0;
+    size_t init_pos = initOffset(carriage_exec_idx_);
+    for(const auto& c:current_carriage_) {
+      if (isInitPending(init_pos++)) {
+        bridge_->clearSlot(pos++);
+      } else {
+        bridge_->publishSlot(pos++, *c);
+      }
+    }
+    bridge_->endPublish(is_ignited_);
+  }
+
   size_t carriage_exec_idx_;
   CarriageUnit carriage_;
+  std::vector<std::shared_ptr<Train>> pending_trains_;
+  std::vector<StagePlan> plan_;
   CarriageTrain train_;
   bool is_ignited_, is_extinguish_;
+  uint64_t tick_, stage_tick_;
+  bool is_verbose_;
+  std::shared_ptr<ShmBridge> bridge_;
+  bool is_realtime_;
+  RealtimeConfig realtime_config_;
+  RealtimeStatus realtime_status_;
+  uint64_t tick_alloc_base_, tick_alloc_count_;
+  uint64_t missed_tick_count_;
+  std::vector<Deadline> stage_deadline_;
+  Deadline train_deadline_;
+  DeadlineQueue<DeadlineTimer> deadline_queue_;
+  uint64_t stage_generation_;
+  ExecutionOutcome outcome_;
+  std::shared_ptr<CheckpointBuffer> checkpoint_;
+  uint32_t checkpoint_every_;
+  std::shared_ptr<SnapshotRing> snapshot_;
+  std::vector<uint64_t> stage_version_;
+  uint64_t publish_version_;
+  size_t last_published_idx_;
+  std::shared_ptr<InitPrefetcher> prefetcher_;
+  std::shared_ptr<InitStateList> init_state_;
+  std::vector<size_t> init_offset_;
+  std::vector<uint8_t> deferred_timeout_;  // the timeouts waiting for a prefetched init() to return
+  size_t prefetch_depth_, prefetched_idx_;
+  bool is_resuming_;
+  bool is_checkpoint_due_;      // a checkpoint was put off while a prefetched init() was in flight
 };
 
 } // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,193 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+namespace actuator_train {
+
+static constexpr uint32_t kCheckpointMagic = 0x4b435441; // "ATCK"
+static constexpr uint16_t kCheckpointVersion = 3;
+static constexpr int kCheckpointReadRetry = 1000;
+
+/**
+ * @class ByteWriter
+ * @brief Write plain values into a fixed size buffer, it never reallocates
+ */
+class ByteWriter {
+public:
+  ByteWriter(uint8_t* buf, const size_t& capacity):
+  buf_(buf), capacity_(capacity), size_(0), is_overflow_(false)
+  {}
+
+  template<typename T>
+  inline void write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Please use plain types");
+    writeBytes(&value, sizeof(T));
+  }
+
+  inline void writeString(const std::string& str) {
+    write(static_cast<uint16_t>(str.size()));
+    writeBytes(str.data(), str.size());
+  }
+
+  inline void writeBytes(const void* data, const size_t& len) {
+    if (size_+len > capacity_) {
+      is_overflow_ = true;
+      return;
+    }
+    std::memcpy(buf_+size_, data, len);
+    size_ += len;
+  }
+
+  inline size_t size() const {return size_;}
+  inline bool isOverflow() const {return is_overflow_;}
+
+private:
+  uint8_t* buf_;
+  size_t capacity_, size_;
+  bool is_overflow_;
+};
+
+/**
+ * @class ByteReader
+ * @brief Read plain values back from a buffer, every read is bounds checked
+ */
+class ByteReader {
+public:
+  explicit ByteReader(const std::vector<uint8_t>& buf):
+  buf_(buf), pos_(0), is_valid_(true)
+  {}
+
+  template<typename T>
+  inline T read() {
+    static_assert(std::is_trivially_copyable<T>::value, "Please use plain types");
+    T value = T();
+    if (pos_+sizeof(T) > buf_.size()) {
+      is_valid_ = false;
+      return value;
+    }
+    std::memcpy(&value, buf_.data()+pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+
+  inline std::string readString() {
+    const auto& len = read<uint16_t>();
+    if (pos_+len > buf_.size()) {
+      is_valid_ = false;
+      return std::string();
+    }
+    std::string str(reinterpret_cast<const char*>(buf_.data()+pos_), len);
+    pos_ += len;
+    return str;
+  }
+
+  inline bool isValid() const {return is_valid_;}
+  inline bool isEnd() const {return pos_ == buf_.size();}
+
+private:
+  const std::vector<uint8_t>& buf_;
+  size_t pos_;
+  bool is_valid_;
+};
+
+/**
+ * @class CheckpointBuffer
+ * @brief Two preallocated snapshot slots, the loop writes the older one while readers copy the newer one
+ */
+class CheckpointBuffer {
+public:
+  CheckpointBuffer():
+  latest_(-1)
+  {
+    for(auto& s:slot_) {
+      s.seq.store(0);
+      s.size = 0;
+    }
+  }
+
+  /**
+   * @brief Allocate both slots, must not be called while the loop writes the buffer. The readers are pointed away
+   *        from the slots first, and the sequence of each slot is bumped so a copy that overlaps is rejected
+   * @param capacity the capacity of one slot in bytes
+   */
+  inline void allocate(const size_t& capacity) {
+    latest_.store(-1, std::memory_order_release);
+    for(auto& s:slot_) {
+      s.seq.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      s.bytes.assign(capacity, 0);
+      s.size = 0;
+      s.seq.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  inline size_t capacity() const {
+    return slot_[0].bytes.size();
+  }
+
+  /**
+   * @brief Start writing the slot the readers are not pointed to
+   * @return a writer over that slot
+   */
+  inline ByteWriter beginWrite() {
+    const int idx = latest_.load(std::memory_order_relaxed)==0?1:0;
+    auto& s = slot_[idx];
+    s.seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return ByteWriter(s.bytes.data(), s.bytes.size());
+  }
+
+  /**
+   * @brief Finish writing, the slot becomes the latest one unless the snapshot did not fit
+   * @param writer the writer returned by beginWrite
+   */
+  inline void endWrite(const ByteWriter& writer) {
+    const int idx = latest_.load(std::memory_order_relaxed)==0?1:0;
+    auto& s = slot_[idx];
+    s.size = writer.isOverflow()?0:writer.size();
+    s.seq.fetch_add(1, std::memory_order_release);
+    if (!writer.isOverflow()) {
+      latest_.store(idx, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Copy the latest snapshot, safe to call while the loop is writing
+   * @param out the snapshot
+   * @return false if there is no snapshot yet or no consistent copy could be taken
+   */
+  bool read(std::vector<uint8_t>& out) const {
+    for(int retry=0;retry<kCheckpointReadRetry;retry++) {
+      const int idx = latest_.load(std::memory_order_acquire);
+      if (idx < 0) {return false;}
+      const auto& s = slot_[idx];
+      const uint64_t s1 = s.seq.load(std::memory_order_acquire);
+      if (s1&1) {continue;}
+      const size_t size = s.size;
+      out.resize(size);
+      std::memcpy(out.data(), s.bytes.data(), size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) == s1) {return true;}
+    }
+    return false;
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> seq;
+    size_t size;
+    std::vector<uint8_t> bytes;
+  };
+
+  Slot slot_[2];
+  std::atomic<int> latest_;
+};
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,152 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <map>
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include "train.h"
+
+namespace actuator_train {
+
+/**
+ * @class FeedbackModel
+ * @brief The model that produces the current values fed to the carriages of a train running in virtual time
+ */
+class FeedbackModel {
+public:
+  virtual ~FeedbackModel() = default;
+
+  /**
+   * @brief Copy this model with a fresh state, every trial runs its own copy
+   * @return the copy
+   */
+  virtual std::shared_ptr<FeedbackModel> clone() const = 0;
+
+  /**
+   * @brief Feed the current values to a carriage of the executing stage, called once per carriage per tick
+   * @param c the carriage
+   * @param tick the virtual tick
+   * @param rng the random engine of the trial
+   */
+  virtual void feed(CarriageMember& c, const uint64_t& tick, std::mt19937_64& rng) = 0;
+};
+
+/**
+ * @struct NoisyFeedbackConfig
+ * @brief The parameters of NoisyFeedback
+ */
+struct NoisyFeedbackConfig {
+  double gain = 0.5;          // fraction of the remaining error the actuator closes per tick
+  double noise_stddev = 0.0;  // gaussian measurement noise
+  double bias = 0.0;          // constant measurement offset
+  size_t delay = 0;           // measurement delay in ticks
+};
+
+/**
+ * @class NoisyFeedback
+ * @brief A first order actuator that approaches its target, measured with noise, bias and delay
+ */
+class NoisyFeedback: public FeedbackModel {
+public:
+  explicit NoisyFeedback(const NoisyFeedbackConfig& config = NoisyFeedbackConfig());
+
+  std::shared_ptr<FeedbackModel> clone() const;
+
+  void feed(CarriageMember& c, const uint64_t& tick, std::mt19937_64& rng);
+
+private:
+  struct Plant {
+    std::vector<double> position;
+    std::deque<std::vector<double>> history;
+  };
+
+  NoisyFeedbackConfig config_;
+  std::unordered_map<const CarriageMember*, Plant> plant_;
+};
+
+/**
+ * @struct EvaluationConfig
+ * @brief The parameters of a Monte Carlo evaluation
+ */
+struct EvaluationConfig {
+  size_t trials = 1000;
+  uint64_t max_ticks = 6000;  // a trial that is still running after it never converges
+  uint64_t seed = 0;
+  size_t threads = 0;         // 0 uses all the cores
+};
+
+/**
+ * @struct Distribution
+ * @brief The summary of a sample, in milliseconds of virtual time
+ */
+struct Distribution {
+  size_t count = 0;
+  double mean = 0.0;
+  double stddev = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double p50 = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+};
+
+/**
+ * @struct EvaluationReport
+ * @brief The aggregated result of a Monte Carlo evaluation
+ */
+struct EvaluationReport {
+  size_t trials = 0;
+  size_t converged = 0;
+  double convergence_rate = 0.0;
+  Distribution completion_ms;                         // over the converged trials
+  std::vector<Distribution> stage_dwell_ms;           // over the trials that finished the stage
+  std::vector<double> stage_stall_rate;               // fraction of trials stuck in the stage
+  std::map<std::string, double> criterion_stall_rate; // fraction of trials stuck on a carriage with the criterion
+};
+
+/**
+ * @class TrainEvaluator
+ * @brief Run many clones of a train in virtual time against a feedback model, spread across the cores
+ */
+class TrainEvaluator {
+public:
+  explicit TrainEvaluator(const EvaluationConfig& config = EvaluationConfig()):
+  config_(config)
+  {}
+  virtual ~TrainEvaluator() = default;
+
+  /**
+   * @brief Evaluate a train
+   * @param train the train, it is cloned and left untouched, every trial resets its clone so it runs from the start
+   * @param model the feedback model, it is cloned for every trial
+   * @return the report
+   */
+  EvaluationReport evaluate(const Train& train, const FeedbackModel& model) const;
+
+  /**
+   * @brief Print the report out
+   * @param report the report
+   */
+  static void observeReport(const EvaluationReport& report);
+
+private:
+  struct Trial {
+    bool is_cloned = false;
+    bool is_converged = false;
+    uint64_t ticks = 0;
+    size_t stall_idx = 0;
+    std::vector<uint64_t> dwell;
+    std::vector<std::string> stall_criterion;
+  };
+
+  void runTrial(const Train& train, const FeedbackModel& model, const size_t& idx, Trial& trial) const;
+
+  static Distribution summarize(std::vector<double> sample);
+
+  EvaluationConfig config_;
+};
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,188 @@
+// last update: 20190815
+// author: yimeng
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include "carriage_base.h"
+
+namespace actuator_train {
+
+static constexpr int kSnapshotSlots = 4;
+
+/**
+ * @struct CarriageView
+ * @brief The state of one carriage in a snapshot
+ */
+struct CarriageView {
+  std::string name;
+  std::string goal_name;
+  std::string equal_name;
+  std::vector<double> target;
+  std::vector<double> current;              // converted from the value type
+  ValueType type;
+  bool is_complete;
+  bool is_inited;
+  ExecutionOutcome outcome;
+};
+
+/**
+ * @struct TrainSnapshot
+ * @brief A consistent view of all the stages of a train
+ */
+struct TrainSnapshot {
+  uint64_t tick;
+  size_t stage_idx;
+  bool is_ignited;
+  std::vector<std::vector<CarriageView>> stages;
+};
+
+/**
+ * @class SnapshotRing
+ * @brief A few preallocated snapshots, the loop fills one that no reader holds and publishes it,
+ *        readers pin the latest one with a reference count, neither side waits for the other
+ */
+class SnapshotRing {
+public:
+
+  /**
+   * @class Handle
+   * @brief A pinned snapshot, it stays unchanged until the handle is released
+   */
+  class Handle {
+  public:
+    Handle():
+    ring_(nullptr), idx_(-1)
+    {}
+    Handle(const SnapshotRing* ring, const int& idx):
+    ring_(ring), idx_(idx)
+    {}
+    Handle(Handle&& h):
+    ring_(h.ring_), idx_(h.idx_)
+    {
+      h.ring_ = nullptr;
+    }
+    Handle& operator=(Handle&& h) {
+      release();
+      ring_ = h.ring_;
+      idx_ = h.idx_;
+      h.ring_ = nullptr;
+      return *this;
+    }
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+    virtual ~Handle() {release();}
+
+    inline bool isValid() const {return ring_ != nullptr;}
+    inline const TrainSnapshot& operator*() const {return ring_->slot_[idx_].data;}
+    inline const TrainSnapshot* operator->() const {return &ring_->slot_[idx_].data;}
+
+    /**
+     * @brief Unpin the snapshot
+     */
+    inline void release() {
+      if (ring_ != nullptr) {
+        ring_->slot_[idx_].readers.fetch_sub(1, std::memory_order_release);
+        ring_ = nullptr;
+      }
+    }
+
+  private:
+    const SnapshotRing* ring_;
+    int idx_;
+  };
+
+  SnapshotRing():
+  latest_(-1),
+  writing_(-1)
+  {
+    for(auto& s:slot_) {s.readers.store(0);}
+  }
+
+  /**
+   * @brief Pin the latest snapshot, safe to call from any thread
+   * @return the handle, invalid if nothing has been published yet
+   */
+  Handle acquire() const {
+    while (true) {
+      const int idx = latest_.load();
+      if (idx < 0) {return Handle();}
+      slot_[idx].readers.fetch_add(1);
+      if (latest_.load() == idx) {return Handle(this, idx);}
+      slot_[idx].readers.fetch_sub(1);
+    }
+  }
+
+  /**
+   * @brief Get a slot that is neither the latest one nor pinned by a reader
+   * @param versions the version of each stage the slot was last written with, to be updated by the writer
+   * @return the slot, nullptr if every other slot is pinned, the publish is then skipped
+   */
+  TrainSnapshot* beginWrite(std::vector<uint64_t>*& versions) {
+    const int latest = latest_.load();
+    for(int i=0;i<kSnapshotSlots;i++) {
+      if (i != latest && slot_[i].readers.load() == 0) {
+        writing_ = i;
+        versions = &slot_[i].stage_version;
+        return &slot_[i].data;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Publish the slot returned by beginWrite
+   */
+  inline void endWrite() {
+    latest_.store(writing_);
+    writing_ = -1;
+  }
+
+  /**
+   * @brief Reset every slot to a layout, must not be called while a reader holds a handle
+   * @param snapshot the layout
+   */
+  void reset(const TrainSnapshot& snapshot) {
+    latest_.store(-1);
+    for(auto& s:slot_) {
+      s.data = snapshot;
+      s.stage_version.assign(snapshot.stages.size(), 0);
+    }
+  }
+
+  /**
+   * @brief Check if the slots have the layout of a train
+   * @param stages the stages of the train
+   * @return same layout or not
+   */
+  template<typename Stages>
+  bool isLayout(const Stages& stages) const {
+    const auto& views = slot_[0].data.stages;
+    if (views.size() != stages.size()) {return false;}
+    size_t i = 0;
+    for(const auto& unit:stages) {
+      if (views[i].size() != unit.size()) {return false;}
+      size_t j = 0;
+      for(const auto& c:unit) {
+        if (views[i][j++].name != c->name()) {return false;}
+      }
+      i++;
+    }
+    return true;
+  }
+
+private:
+  struct Slot {
+    mutable std::atomic<uint32_t> readers;
+    TrainSnapshot data;
+    std::vector<uint64_t> stage_version;
+  };
+
+  Slot slot_[kSnapshotSlots];
+  std::atomic<int> latest_;
+  int writing_;
+};
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,48 @@
+// last update: 20190815
+// author: yimeng
+
+// The global operator new/delete replacement behind the heap allocation check of real-time mode.
+// It is built as the separate actuator_train_alloc_check library, only a process that links it
+// gets its allocator replaced.
+
+#include <new>
+#include <cstdlib>
+
+#include "realtime.h"
+
+namespace {
+
+inline void* countedAlloc(std::size_t size) {
+  actuator_train::countAllocation();
+  return std::malloc(size?size:1);
+}
+
+struct HookInstaller {
+  HookInstaller() {actuator_train::installAllocationHook();}
+};
+
+HookInstaller installer;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+  void* p = countedAlloc(size);
+  if (p == nullptr) {throw std::bad_alloc();}
+  return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
\ No newline at end of file
@@ -19,4 +19,8 @@ void BarActuator::proc() {
   std::cout << "BarActuator running " << n++ << std::endl;
 }    
 
+std::shared_ptr<Carriage<double>> BarActuator::clone() const {
+  return std::make_shared<BarActuator>(*this);
+}
+
 } // namespace actuator_train
\ No newline at end of file
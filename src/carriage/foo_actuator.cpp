@@ -20,4 +20,8 @@ void FooActuator::proc() {
   std::cout << "FooActuator running " << n++ << std::endl;
 }
 
+std::shared_ptr<Carriage<double>> FooActuator::clone() const {
+  return std::make_shared<FooActuator>(*this);
+}
+
 } // namespace actuator_train
\ No newline at end of file
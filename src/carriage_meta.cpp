@@ -0,0 +1,58 @@
+// last update: 20190815
+// author: yimeng
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include "carriage_meta.h"
+
+namespace actuator_train {
+
+namespace {
+
+std::mutex& tableMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<CarriageMeta, size_t>& table() {
+  static std::map<CarriageMeta, size_t> metas;  // the metadata and its reference count
+  return metas;
+}
+
+} // namespace
+
+bool CarriageMeta::operator<(const CarriageMeta& m) const {
+  return std::tie(name, goal_name, equal_name, is_standard_goal, tolerance, update_freq, update_div,
+                  deadline.ms, deadline.policy, deadline.stop) <
+         std::tie(m.name, m.goal_name, m.equal_name, m.is_standard_goal, m.tolerance, m.update_freq, m.update_div,
+                  m.deadline.ms, m.deadline.policy, m.deadline.stop);
+}
+
+const CarriageMeta* CarriageMetaTable::intern(const CarriageMeta& meta) {
+  std::lock_guard<std::mutex> lock(tableMutex());
+  auto it = table().insert(std::make_pair(meta, 0)).first;
+  it->second++;
+  return &it->first;
+}
+
+void CarriageMetaTable::acquire(const CarriageMeta* meta) {
+  if (meta == nullptr) {return;}
+  std::lock_guard<std::mutex> lock(tableMutex());
+  auto it = table().find(*meta);
+  if (it != table().end()) {it->second++;}
+}
+
+void CarriageMetaTable::release(const CarriageMeta* meta) {
+  if (meta == nullptr) {return;}
+  std::lock_guard<std::mutex> lock(tableMutex());
+  auto it = table().find(*meta);
+  if (it != table().end() && --it->second == 0) {table().erase(it);}
+}
+
+size_t CarriageMetaTable::size() {
+  std::lock_guard<std::mutex> lock(tableMutex());
+  return table().size();
+}
+
+} // namespace actuator_train
\ No newline at end of file
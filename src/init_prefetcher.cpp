@@ -0,0 +1,70 @@
+// last update: 20190815
+// author: yimeng
+
+#include "init_prefetcher.h"
+
+namespace actuator_train {
+
+InitPrefetcher::InitPrefetcher(const size_t& workers):
+running_(0), is_stopped_(false) {
+  const size_t size = workers>0?workers:1;
+  for(size_t i=0;i<size;i++) {
+    workers_.emplace_back(&InitPrefetcher::work, this);
+  }
+}
+
+InitPrefetcher::~InitPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(auto& job:jobs_) {
+      (*job.states)[job.idx].store(static_cast<uint8_t>(InitState::Idle));
+    }
+    jobs_.clear();
+    is_stopped_ = true;
+  }
+  job_cv_.notify_all();
+  for(auto& w:workers_) {w.join();}
+}
+
+void InitPrefetcher::submit(const std::shared_ptr<CarriageBase>& c,
+                            const std::shared_ptr<InitStateList>& states,
+                            const size_t& idx) {
+  (*states)[idx].store(static_cast<uint8_t>(InitState::Queued));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(Job{c, states, idx});
+  }
+  job_cv_.notify_one();
+}
+
+void InitPrefetcher::cancel() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for(auto& job:jobs_) {
+    (*job.states)[job.idx].store(static_cast<uint8_t>(InitState::Idle));
+  }
+  jobs_.clear();
+  idle_cv_.wait(lock, [this]() {return running_ == 0;});
+}
+
+void InitPrefetcher::work() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_cv_.wait(lock, [this]() {return is_stopped_ || !jobs_.empty();});
+      if (is_stopped_) {return;}
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      running_++;
+    }
+    job.carriage->init();
+    (*job.states)[job.idx].store(static_cast<uint8_t>(InitState::Done), std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_--;
+    }
+    idle_cv_.notify_all();
+  }
+}
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,168 @@
+// last update: 20190815
+// author: yimeng
+
+#include "realtime.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "carriage_base.h"
+
+namespace {
+
+thread_local bool is_allocation_checked = false;
+thread_local uint64_t allocation_count = 0;
+std::atomic<bool> is_hook_installed(false);
+
+std::mutex memory_lock_mutex;
+size_t memory_lock_count = 0;      // the applied settings that hold the memory lock
+bool is_memory_lock_owned = false; // the memory was not locked before the first of them
+
+/**
+ * @brief Check if the process has locked pages, read from VmLck in /proc/self/status
+ * @return locked or not
+ */
+bool isMemoryLocked() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmLck:") {
+      size_t kb = 0;
+      status >> kb;
+      return kb > 0;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return false;
+}
+
+} // namespace
+
+namespace actuator_train {
+
+RealtimeStatus applyRealtime(const RealtimeConfig& config, RealtimeState& previous) {
+  RealtimeStatus status;
+  previous = RealtimeState();
+  if (config.priority > 0) {
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    int policy = 0;
+    const bool is_saved = pthread_getschedparam(pthread_self(), &policy, &param) == 0;
+    const int old_priority = param.sched_priority;
+    param.sched_priority = config.priority;
+    const int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (ret == 0) {
+      status.is_fifo = true;
+      previous.is_sched_saved = is_saved;
+      previous.policy = policy;
+      previous.priority = old_priority;
+    } else {
+      std::cerr << FUNC_NAME << "SCHED_FIFO priority " << config.priority
+                << " is not permitted, keep the default scheduler: " << std::strerror(ret) << std::endl;
+    }
+  }
+  if (!config.cpus.empty()) {
+    cpu_set_t old_set;
+    CPU_ZERO(&old_set);
+    const bool is_saved = pthread_getaffinity_np(pthread_self(), sizeof(old_set), &old_set) == 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(const auto& cpu:config.cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        std::cerr << FUNC_NAME << "CPU " << cpu << " is out of range, ignore it" << std::endl;
+        continue;
+      }
+      CPU_SET(cpu, &set);
+    }
+    const int ret = CPU_COUNT(&set)>0?pthread_setaffinity_np(pthread_self(), sizeof(set), &set):EINVAL;
+    if (ret == 0) {
+      status.is_pinned = true;
+      previous.is_affinity_saved = is_saved;
+      for(int cpu=0;is_saved && cpu<CPU_SETSIZE;cpu++) {
+        if (CPU_ISSET(cpu, &old_set)) {previous.cpus.push_back(cpu);}
+      }
+    } else {
+      std::cerr << FUNC_NAME << "Cannot pin the thread, keep the affinity: " << std::strerror(ret) << std::endl;
+    }
+  }
+  if (config.lock_memory) {
+    std::lock_guard<std::mutex> lock(memory_lock_mutex);
+    const bool was_locked = memory_lock_count == 0 && isMemoryLocked();
+    if (mlockall(MCL_CURRENT|MCL_FUTURE) == 0) {
+      if (memory_lock_count++ == 0) {is_memory_lock_owned = !was_locked;}
+      status.is_memory_locked = true;
+      previous.is_memory_locked = true;
+    } else {
+      std::cerr << FUNC_NAME << "Cannot lock memory: " << std::strerror(errno) << std::endl;
+    }
+  }
+  if (config.check_allocation && !is_hook_installed.load()) {
+    std::cerr << FUNC_NAME << "The allocation hook is not linked, "
+              << "link actuator_train_alloc_check to count heap allocations" << std::endl;
+  }
+  if (config.prefault_stack > 0) {
+    prefaultStack(config.prefault_stack);
+  }
+  return status;
+}
+
+void restoreRealtime(const RealtimeState& previous) {
+  if (previous.is_sched_saved) {
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = previous.priority;
+    const int ret = pthread_setschedparam(pthread_self(), previous.policy, &param);
+    if (ret != 0) {
+      std::cerr << FUNC_NAME << "Cannot restore the scheduler: " << std::strerror(ret) << std::endl;
+    }
+  }
+  if (previous.is_affinity_saved) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(const auto& cpu:previous.cpus) {CPU_SET(cpu, &set);}
+    const int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (ret != 0) {
+      std::cerr << FUNC_NAME << "Cannot restore the affinity: " << std::strerror(ret) << std::endl;
+    }
+  }
+  if (previous.is_memory_locked) {
+    std::lock_guard<std::mutex> lock(memory_lock_mutex);
+    if (--memory_lock_count == 0 && is_memory_lock_owned && munlockall() != 0) {
+      std::cerr << FUNC_NAME << "Cannot unlock memory: " << std::strerror(errno) << std::endl;
+    }
+  }
+}
+
+void __attribute__((noinline)) prefaultStack(const size_t& bytes) {
+  auto* buf = static_cast<volatile char*>(alloca(bytes));
+  for(size_t i=0;i<bytes;i+=4096) {buf[i] = 0;}
+}
+
+void setAllocationCheck(const bool& enable) {
+  is_allocation_checked = enable;
+}
+
+uint64_t allocationCount() {
+  return allocation_count;
+}
+
+void countAllocation() {
+  if (is_allocation_checked) {allocation_count++;}
+}
+
+void installAllocationHook() {
+  is_hook_installed.store(true);
+}
+
+} // namespace actuator_train
\ No newline at end of file
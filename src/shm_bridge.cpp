@@ -0,0 +1,185 @@
+// last update: 20190815
+// author: yimeng
+
+#include "shm_bridge.h"
+
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace actuator_train {
+
+static constexpr int kBridgeReadRetry = 1000;
+
+ShmBridge::ShmBridge(const std::string& name):
+name_(name), region_(nullptr), is_owner_(false) {
+  last_seen_.fill(0);
+}
+
+ShmBridge::~ShmBridge() {
+  if (region_ != nullptr) {
+    munmap(region_, sizeof(BridgeRegion));
+    if (is_owner_) {shm_unlink(name_.c_str());}
+  }
+}
+
+bool ShmBridge::create() {
+  return map(true);
+}
+
+bool ShmBridge::attach() {
+  return map(false);
+}
+
+bool ShmBridge::map(const bool& is_owner) {
+  if (region_ != nullptr) {
+    std::cerr << FUNC_NAME << "Bridge " << name_ << " is already mapped!" << std::endl;
+    return false;
+  }
+  const int flags = is_owner?(O_CREAT|O_RDWR):O_RDWR;
+  const int fd = shm_open(name_.c_str(), flags, 0666);
+  if (fd < 0) {
+    std::cerr << FUNC_NAME << "Cannot open shared memory: " << name_ << std::endl;
+    return false;
+  }
+  if (is_owner && ftruncate(fd, sizeof(BridgeRegion)) != 0) {
+    std::cerr << FUNC_NAME << "Cannot resize shared memory: " << name_ << std::endl;
+    close(fd);
+    return false;
+  }
+  void* addr = mmap(nullptr, sizeof(BridgeRegion), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    std::cerr << FUNC_NAME << "Cannot map shared memory: " << name_ << std::endl;
+    return false;
+  }
+  auto* region = static_cast<BridgeRegion*>(addr);
+  if (is_owner) {
+    std::memset(addr, 0, sizeof(BridgeRegion));
+    region = new (addr) BridgeRegion();
+    region->magic = kBridgeMagic;
+    region->version = kBridgeVersion;
+  } else if (region->magic != kBridgeMagic || region->version != kBridgeVersion) {
+    std::cerr << FUNC_NAME << "Shared memory " << name_ << " is not a train bridge!" << std::endl;
+    munmap(addr, sizeof(BridgeRegion));
+    return false;
+  }
+  region_ = region;
+  is_owner_ = is_owner;
+  return true;
+}
+
+void ShmBridge::beginPublish(const size_t& stage_idx, const uint64_t& tick, const size_t& size) {
+  region_->seq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  region_->stage_idx = stage_idx;
+  region_->tick = tick;
+  region_->carriage_size = size<kBridgeMaxCarriages?size:kBridgeMaxCarriages;
+}
+
+void ShmBridge::publishSlot(const size_t& pos, const CarriageBase& c) {
+  if (pos >= kBridgeMaxCarriages) {return;}
+  auto& s = region_->slot[pos];
+  std::strncpy(s.name, c.name().c_str(), kBridgeNameLen-1);
+  s.name[kBridgeNameLen-1] = '\0';
+  s.len = c.size()<kBridgeMaxValues?c.size():kBridgeMaxValues;
+  s.is_complete = c.isComplete();
+  for(size_t i=0;i<s.len;i++) {
+    s.target[i] = c.targetValue(i);
+    s.current[i] = c.currentValue(i);
+  }
+}
+
+void ShmBridge::clearSlot(const size_t& pos) {
+  if (pos >= kBridgeMaxCarriages) {return;}
+  auto& s = region_->slot[pos];
+  s.name[0] = '\0';
+  s.len = 0;
+  s.is_complete = false;
+}
+
+void ShmBridge::endPublish(const bool& is_ignited) {
+  region_->is_ignited = is_ignited;
+  region_->seq.fetch_add(1, std::memory_order_release);
+}
+
+bool ShmBridge::consumeSlot(const size_t& pos, const size_t& stage_idx, CarriageBase& c) {
+  if (pos >= kBridgeMaxCarriages) {return false;}
+  auto& in = region_->inbox[pos];
+  const uint64_t s1 = in.seq.load(std::memory_order_acquire);
+  if (s1 == last_seen_[pos] || (s1&1)) {return false;}
+  double values[kBridgeMaxValues];
+  const uint64_t stage = in.stage_idx;
+  const uint32_t len = in.len<kBridgeMaxValues?in.len:kBridgeMaxValues;
+  std::memcpy(values, in.current, sizeof(values));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (in.seq.load(std::memory_order_relaxed) != s1) {return false;}
+  last_seen_[pos] = s1;
+  if (stage != stage_idx) {return false;}
+  const size_t n = len<c.size()?len:c.size();
+  for(size_t i=0;i<n;i++) {c.setCurrentValue(i, values[i]);}
+  return true;
+}
+
+bool ShmBridge::read(BridgeView& view) const {
+  if (region_ == nullptr) {
+    std::cerr << FUNC_NAME << "Bridge " << name_ << " is not mapped!" << std::endl;
+    return false;
+  }
+  for(int retry=0;retry<kBridgeReadRetry;retry++) {
+    const uint64_t s1 = region_->seq.load(std::memory_order_acquire);
+    if (s1&1) {continue;}
+    view.tick = region_->tick;
+    view.stage_idx = region_->stage_idx;
+    view.is_ignited = region_->is_ignited;
+    view.carriage_size = region_->carriage_size<kBridgeMaxCarriages?
+                         region_->carriage_size:kBridgeMaxCarriages;
+    std::memcpy(view.slot.data(), region_->slot, sizeof(BridgeSlot)*view.carriage_size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (region_->seq.load(std::memory_order_relaxed) == s1) {return true;}
+  }
+  return false;
+}
+
+bool ShmBridge::feedCurrent(const std::string& name, const double* values, const size_t& len) {
+  if (region_ == nullptr) {
+    std::cerr << FUNC_NAME << "Bridge " << name_ << " is not mapped!" << std::endl;
+    return false;
+  }
+  size_t pos = kBridgeMaxCarriages;
+  uint64_t stage_idx = 0;
+  for(int retry=0;retry<kBridgeReadRetry;retry++) {
+    const uint64_t s1 = region_->seq.load(std::memory_order_acquire);
+    if (s1&1) {continue;}
+    pos = kBridgeMaxCarriages;
+    stage_idx = region_->stage_idx;
+    const uint32_t size = region_->carriage_size<kBridgeMaxCarriages?
+                          region_->carriage_size:kBridgeMaxCarriages;
+    for(size_t i=0;i<size;i++) {
+      if (std::strncmp(region_->slot[i].name, name.c_str(), kBridgeNameLen-1) == 0) {
+        pos = i;
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (region_->seq.load(std::memory_order_relaxed) == s1) {break;}
+    pos = kBridgeMaxCarriages;
+  }
+  if (pos == kBridgeMaxCarriages) {return false;}
+
+  auto& in = region_->inbox[pos];
+  uint64_t s = in.seq.load(std::memory_order_relaxed);
+  if ((s&1) || !in.seq.compare_exchange_strong(s, s+1, std::memory_order_acquire)) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  in.stage_idx = stage_idx;
+  in.len = len<kBridgeMaxValues?len:kBridgeMaxValues;
+  for(size_t i=0;i<in.len;i++) {in.current[i] = values[i];}
+  in.seq.store(s+2, std::memory_order_release);
+  return true;
+}
+
+} // namespace actuator_train
\ No newline at end of file
@@ -0,0 +1,184 @@
+// last update: 20190815
+// author: yimeng
+
+#include "train_evaluator.h"
+
+#include <set>
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+
+namespace actuator_train {
+
+NoisyFeedback::NoisyFeedback(const NoisyFeedbackConfig& config):
+config_(config) {}
+
+std::shared_ptr<FeedbackModel> NoisyFeedback::clone() const {
+  return std::make_shared<NoisyFeedback>(config_);
+}
+
+void NoisyFeedback::feed(CarriageMember& c, const uint64_t& /*tick*/, std::mt19937_64& rng) {
+  auto& plant = plant_[&c];
+  if (plant.position.size() != c.size()) {
+    plant.position.assign(c.size(), 0.0);
+    for(size_t i=0;i<c.size();i++) {plant.position[i] = c.currentValue(i);}
+  }
+  for(size_t i=0;i<c.size();i++) {
+    plant.position[i] += config_.gain*(c.targetValue(i)-plant.position[i]);
+  }
+  plant.history.push_back(plant.position);
+  while (plant.history.size() > config_.delay+1) {plant.history.pop_front();}
+
+  std::normal_distribution<double> noise(0.0, config_.noise_stddev);
+  const auto& measured = plant.history.front();
+  for(size_t i=0;i<c.size();i++) {
+    const double n = config_.noise_stddev>0.0?noise(rng):0.0;
+    c.setCurrentValue(i, measured[i]+config_.bias+n);
+  }
+}
+
+EvaluationReport TrainEvaluator::evaluate(const Train& train, const FeedbackModel& model) const {
+  EvaluationReport report;
+  if (train.getTrainSize() == 0) {
+    std::cerr << FUNC_NAME << "An empty train cannot be evaluated!" << std::endl;
+    return report;
+  }
+  std::vector<Trial> trials(config_.trials);
+  std::atomic<size_t> next(0);
+  size_t thread_size = config_.threads>0?config_.threads:std::thread::hardware_concurrency();
+  thread_size = std::max<size_t>(1, std::min(thread_size, config_.trials));
+  std::vector<std::thread> workers;
+  for(size_t i=0;i<thread_size;i++) {
+    workers.emplace_back([&]() {
+      for(size_t idx=next++;idx<trials.size();idx=next++) {
+        runTrial(train, model, idx, trials[idx]);
+      }
+    });
+  }
+  for(auto& w:workers) {w.join();}
+  for(const auto& t:trials) {
+    if (!t.is_cloned) {
+      std::cerr << FUNC_NAME << "The train cannot be cloned for the trials!" << std::endl;
+      return report;
+    }
+  }
+
+  const size_t stage_size = train.getTrainSize();
+  const double tick_ms = 1000.0/train.loop_rate_;
+  std::vector<double> completion;
+  std::vector<std::vector<double>> dwell(stage_size);
+  std::vector<size_t> stall(stage_size, 0);
+  std::map<std::string, size_t> criterion_stall;
+  for(const auto& t:trials) {
+    if (t.is_converged) {
+      completion.push_back(t.ticks*tick_ms);
+    } else {
+      stall[t.stall_idx]++;
+      for(const auto& criterion:t.stall_criterion) {criterion_stall[criterion]++;}
+    }
+    for(size_t i=0;i<t.dwell.size();i++) {
+      dwell[i].push_back(t.dwell[i]*tick_ms);
+    }
+  }
+
+  report.trials = trials.size();
+  report.converged = completion.size();
+  report.convergence_rate = report.trials>0?static_cast<double>(report.converged)/report.trials:0.0;
+  report.completion_ms = summarize(std::move(completion));
+  for(size_t i=0;i<stage_size;i++) {
+    report.stage_dwell_ms.push_back(summarize(std::move(dwell[i])));
+    report.stage_stall_rate.push_back(report.trials>0?static_cast<double>(stall[i])/report.trials:0.0);
+  }
+  for(const auto& c:criterion_stall) {
+    report.criterion_stall_rate[c.first] = static_cast<double>(c.second)/report.trials;
+  }
+  return report;
+}
+
+void TrainEvaluator::runTrial(const Train& train, const FeedbackModel& model,
+                              const size_t& idx, Trial& trial) const {
+  Train t;
+  if (!train.clone(t)) {return;}
+  trial.is_cloned = true;
+  t.reset();
+  t.setVerbose(false);
+  auto m = model.clone();
+  std::seed_seq seq{config_.seed, static_cast<uint64_t>(idx)};
+  std::mt19937_64 rng(seq);
+  if (!t.prepare()) {return;}
+
+  IgniteResult result = IgniteResult::Success;
+  uint64_t stage_enter = 0;
+  bool is_running = true;
+  while (is_running && trial.ticks < config_.max_ticks) {
+    const size_t stage_idx = t.getCarriageExecIdx();
+    for(auto& c:t.getStage(stage_idx)) {
+      m->feed(*c, trial.ticks, rng);
+    }
+    is_running = t.step(result);
+    trial.ticks++;
+    if (!is_running || t.getCarriageExecIdx() != stage_idx) {
+      trial.dwell.push_back(trial.ticks-stage_enter);
+      stage_enter = trial.ticks;
+    }
+  }
+  trial.is_converged = !is_running && result == IgniteResult::Success;
+  if (!trial.is_converged) {
+    trial.stall_idx = t.getCarriageExecIdx();
+    std::set<std::string> criteria;
+    for(const auto& c:t.getStage(trial.stall_idx)) {
+      if (!c->isComplete()) {criteria.insert(c->equalName());}
+    }
+    trial.stall_criterion.assign(criteria.begin(), criteria.end());
+  }
+}
+
+Distribution TrainEvaluator::summarize(std::vector<double> sample) {
+  Distribution d;
+  d.count = sample.size();
+  if (sample.empty()) {return d;}
+  std::sort(sample.begin(), sample.end());
+  const auto& percentile = [&sample](const double& p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p*sample.size()));
+    return sample[rank>0?rank-1:0];
+  };
+  d.mean = std::accumulate(sample.begin(), sample.end(), 0.0)/d.count;
+  double var = 0.0;
+  for(const auto& s:sample) {var += (s-d.mean)*(s-d.mean);}
+  d.stddev = std::sqrt(var/d.count);
+  d.min = sample.front();
+  d.max = sample.back();
+  d.p50 = percentile(0.5);
+  d.p90 = percentile(0.9);
+  d.p99 = percentile(0.99);
+  return d;
+}
+
+void TrainEvaluator::observeReport(const EvaluationReport& report) {
+  const auto& print = [](std::ostringstream& oss, const Distribution& d) {
+    oss << "[Count]:" << d.count << ", [Mean]:" << d.mean << ", [Std]:" << d.stddev
+        << ", [Min]:" << d.min << ", [P50]:" << d.p50 << ", [P90]:" << d.p90
+        << ", [P99]:" << d.p99 << ", [Max]:" << d.max << std::endl;
+  };
+  std::ostringstream oss;
+  oss << "--------------------------------------" <<
+  "------------------------------------------" << std::endl;
+  oss << "{Evaluation summary}" << std::endl;
+  oss << "[Trials]:" << report.trials << ", [Converged]:" << report.converged
+      << ", [Rate]:" << report.convergence_rate << std::endl;
+  oss << "[Completion ms] ";
+  print(oss, report.completion_ms);
+  for(size_t i=0;i<report.stage_dwell_ms.size();i++) {
+    oss << "[ Stage " << i << " ] [Stall rate]:" << report.stage_stall_rate[i] << std::endl;
+    oss << "  [Dwell ms] ";
+    print(oss, report.stage_dwell_ms[i]);
+  }
+  for(const auto& c:report.criterion_stall_rate) {
+    oss << "[Criterion]:" << c.first << ", [Stall rate]:" << c.second << std::endl;
+  }
+  oss << "--------------------------------------" <<
+  "------------------------------------------" << std::endl;
+  std::cout << oss.str();
+}
+
+} // namespace actuator_train
\ No newline at end of file